@@ -0,0 +1,216 @@
+/**
+ * @file AuditLog.cpp
+ * @brief Implementation of the flash audit log
+ */
+
+#include "AuditLog.h"
+
+#include <cstring>
+#include <ctime>
+
+AuditLog::AuditLog()
+    : _thread(osPriorityLow, 1536, nullptr, "audit"), _ready(false), _start(0), _sectorSize(0),
+      _slotsPerSector(0), _sector(0), _slot(0), _generation(0), _staged(0), _nextSequence(0),
+      _dropped(0) {
+}
+
+template <typename T>
+uint32_t AuditLog::crcOf(const T& item) {
+    // Every stored structure ends with its CRC
+    MbedCRC<POLY_32BIT_ANSI, 32> crc32;
+    uint32_t crc = 0;
+    crc32.compute(&item, sizeof(T) - sizeof(uint32_t), &crc);
+    return crc;
+}
+
+bool AuditLog::init(uint32_t regionEnd) {
+    if (regionEnd == 0 || _flash.init() != 0) {
+        return false;
+    }
+    _sectorSize = _flash.get_sector_size(regionEnd - 1);
+    _slotsPerSector = (_sectorSize - sizeof(SectorHeader)) / sizeof(Entry);
+    _start = regionEnd - AUDIT_LOG_SECTORS * _sectorSize;
+    if (_start < FLASHIAP_APP_ROM_END_ADDR) {
+        return false;
+    }
+    
+    // The sector with the highest generation is the one being written
+    bool found = false;
+    for (uint32_t s = 0; s < AUDIT_LOG_SECTORS; s++) {
+        SectorHeader header;
+        if (readSectorHeader(s, header) && (!found || header.generation > _generation)) {
+            found = true;
+            _sector = s;
+            _generation = header.generation;
+            _nextSequence = header.firstSequence;
+        }
+    }
+    
+    if (!found) {
+        _nextSequence = 1;
+        if (!startSector(0, 1, _nextSequence)) {
+            return false;
+        }
+    } else {
+        // Entries fill a sector in order: binary search for the first erased slot
+        uint32_t low = 0;
+        uint32_t high = _slotsPerSector;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (slotErased(_sector, mid)) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        _slot = low;
+        _nextSequence += low;
+    }
+    
+    _ready = true;
+    _thread.start(callback(this, &AuditLog::run));
+    return true;
+}
+
+void AuditLog::record(Event event, uint8_t arg, uint16_t userId) {
+    if (!_ready) {
+        return;
+    }
+    
+    _mutex.lock();
+    bool first = _staged == 0;
+    if (_staged >= AUDIT_LOG_STAGING) {
+        _dropped++;
+    } else {
+        Entry& entry = _staging[_staged++];
+        entry.sequence = _nextSequence++;
+        entry.time = static_cast<uint32_t>(time(nullptr));
+        entry.event = event;
+        entry.arg = arg;
+        entry.userId = userId;
+        entry.crc = crcOf(entry);
+    }
+    bool batchReady = _staged >= AUDIT_LOG_BATCH;
+    _mutex.unlock();
+    
+    // Small batches wait for AUDIT_LOG_FLUSH_MS to collect more entries
+    if (first) {
+        _flags.set(FLAG_STAGED);
+    }
+    if (batchReady) {
+        _flags.set(FLAG_FLUSH);
+    }
+}
+
+bool AuditLog::readRecent(uint32_t age, Entry& entry) {
+    if (!_ready) {
+        return false;
+    }
+    
+    // Walk back from the write position a whole sector at a time
+    _flashMutex.lock();
+    uint32_t sector = _sector;
+    uint32_t slot = _slot;          // Entries in this sector older than the write position
+    bool found = true;
+    while (age >= slot) {
+        age -= slot;
+        sector = (sector + AUDIT_LOG_SECTORS - 1) % AUDIT_LOG_SECTORS;
+        SectorHeader header;
+        if (sector == _sector || !readSectorHeader(sector, header) ||
+            header.generation >= _generation) {
+            found = false;  // Wrapped round, never written, or erased mid-rotation
+            break;
+        }
+        slot = _slotsPerSector;
+    }
+    if (found) {
+        _flash.read(&entry, slotAddress(sector, slot - 1 - age), sizeof(entry));
+    }
+    _flashMutex.unlock();
+    
+    return found && entry.crc == crcOf(entry);
+}
+
+// ==================== FLASH SIDE ====================
+
+bool AuditLog::readSectorHeader(uint32_t sector, SectorHeader& header) {
+    _flash.read(&header, sectorAddress(sector), sizeof(header));
+    return header.magic == MAGIC && header.crc == crcOf(header);
+}
+
+bool AuditLog::slotErased(uint32_t sector, uint32_t slot) {
+    uint32_t sequence;
+    _flash.read(&sequence, slotAddress(sector, slot), sizeof(sequence));
+    return sequence == 0xFFFFFFFF;
+}
+
+bool AuditLog::startSector(uint32_t sector, uint32_t generation, uint32_t firstSequence) {
+    if (_flash.erase(sectorAddress(sector), _sectorSize) != 0) {
+        return false;
+    }
+    SectorHeader header = {MAGIC, generation, firstSequence, 0};
+    header.crc = crcOf(header);
+    if (_flash.program(&header, sectorAddress(sector), sizeof(header)) != 0) {
+        return false;
+    }
+    _sector = sector;
+    _slot = 0;
+    _generation = generation;
+    return true;
+}
+
+void AuditLog::flush() {
+    Entry batch[AUDIT_LOG_STAGING];
+    
+    _mutex.lock();
+    uint32_t count = _staged;
+    memcpy(batch, _staging, count * sizeof(Entry));
+    _staged = 0;
+    _flags.clear(FLAG_FLUSH);  // Set for entries this batch already holds
+    _mutex.unlock();
+    
+    _flashMutex.lock();
+    uint32_t written = 0;
+    while (written < count) {
+        if (_slot >= _slotsPerSector) {
+            // Rotate: the oldest sector is erased to make room
+            uint32_t next = (_sector + 1) % AUDIT_LOG_SECTORS;
+            if (!startSector(next, _generation + 1, batch[written].sequence)) {
+                break;
+            }
+        }
+        
+        // One program call per contiguous run - entries are whole program units
+        uint32_t run = count - written;
+        if (run > _slotsPerSector - _slot) {
+            run = _slotsPerSector - _slot;
+        }
+        if (_flash.program(&batch[written], slotAddress(_sector, _slot), run * sizeof(Entry)) != 0) {
+            break;
+        }
+        _slot += run;
+        written += run;
+    }
+    _flashMutex.unlock();
+    
+    if (written < count) {
+        _mutex.lock();
+        _dropped += count - written;
+        _mutex.unlock();
+    }
+}
+
+void AuditLog::run() {
+    while (true) {
+        // No timeout while nothing is staged, so an idle log never wakes the core
+        _flags.wait_any(FLAG_STAGED);
+        _flags.wait_any_for(FLAG_FLUSH, std::chrono::milliseconds(AUDIT_LOG_FLUSH_MS));
+        
+        _mutex.lock();
+        bool pending = _staged > 0;
+        _mutex.unlock();
+        if (pending) {
+            flush();
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file AuditLog.h
+ * @brief Append-only audit log in a ring of flash sectors
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * record() only copies a 16-byte entry into a RAM staging buffer; a low-priority
+ * thread writes the staged entries in batches and does any sector erase, so the
+ * unlock path never waits on flash. Sectors are used round-robin (the oldest is
+ * erased when the newest fills up), which spreads wear evenly.
+ * 
+ * Every sector starts with a header holding its generation and the sequence
+ * number of its first entry, and every entry carries a CRC. Recovery reads the
+ * sector headers and binary-searches the newest sector for its first erased slot,
+ * so opening the log costs a few dozen flash reads whatever its size.
+ */
+
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include "mbed.h"
+#include "DoorIO.h"    // AuditSink (event codes)
+#include "config.h"  // AUDIT_LOG_SECTORS, AUDIT_LOG_STAGING, AUDIT_LOG_FLUSH_MS
+
+/**
+ * @class AuditLog
+ * @brief Batched, CRC-protected, wear-levelled flash log
+ */
+class AuditLog : public AuditSink {
+public:
+    /**
+     * @brief One log entry as stored in flash (16 bytes, two program units)
+     */
+    struct Entry {
+        uint32_t sequence;          // Increases by one per entry, across reboots
+        uint32_t time;              // RTC seconds (time(NULL)); below AUDIT_CLOCK_MIN_EPOCH the clock was unset
+        uint8_t event;
+        uint8_t arg;
+        uint16_t userId;
+        uint32_t crc;               // CRC-32 of the fields above
+    };
+    
+    AuditLog();
+    
+    /**
+     * @brief Open the log and start the flush thread
+     * @param regionEnd Address just past the log (its sectors are below it)
+     * @return false if the flash region is unusable
+     */
+    bool init(uint32_t regionEnd);
+    
+    /**
+     * @brief Stage an entry (never touches flash, never blocks on it)
+     * @param event What happened
+     * @param arg Event-specific detail
+     * @param userId User involved, or NO_USER
+     */
+    void record(Event event, uint8_t arg = 0, uint16_t userId = NO_USER) override;
+    
+    /**
+     * @brief Read a flushed entry, newest first
+     * Skips whole sectors, so any age costs at most one header read per sector.
+     * @param age 0 = newest
+     * @return false past the oldest entry or on a corrupt one
+     */
+    bool readRecent(uint32_t age, Entry& entry);
+    
+    /**
+     * @brief Most entries the log can hold (0 if init() failed)
+     */
+    uint32_t capacity() const {
+        return _ready ? AUDIT_LOG_SECTORS * _slotsPerSector : 0;
+    }
+    
+    /**
+     * @brief Lowest flash address used by the log (0 if init() failed)
+     */
+    uint32_t regionStart() const {
+        return _ready ? _start : 0;
+    }
+    
+    /**
+     * @brief Entries lost because the staging buffer was full
+     */
+    uint32_t dropped() const {
+        return _dropped;
+    }
+    
+private:
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t generation;        // Highest is the sector being written
+        uint32_t firstSequence;     // Sequence number of slot 0
+        uint32_t crc;
+    };
+    
+    static const uint32_t MAGIC = 0x4C4F4741;       // 'LOGA'
+    static const uint32_t FLAG_STAGED = 1;          // First entry staged: start the flush timeout
+    static const uint32_t FLAG_FLUSH = 2;           // AUDIT_LOG_BATCH entries staged: flush now
+    
+    FlashIAP _flash;
+    Mutex _mutex;                   // Guards the staging buffer, _nextSequence and _dropped
+    Mutex _flashMutex;              // Guards the flash position below
+    EventFlags _flags;
+    Thread _thread;
+    bool _ready;
+    uint32_t _start;                // First sector address
+    uint32_t _sectorSize;
+    uint32_t _slotsPerSector;
+    
+    // Flash position
+    uint32_t _sector;               // Sector being written
+    uint32_t _slot;                 // Next free slot in it
+    uint32_t _generation;
+    
+    Entry _staging[AUDIT_LOG_STAGING];
+    uint32_t _staged;
+    uint32_t _nextSequence;
+    volatile uint32_t _dropped;
+    
+    uint32_t sectorAddress(uint32_t sector) const {
+        return _start + sector * _sectorSize;
+    }
+    
+    uint32_t slotAddress(uint32_t sector, uint32_t slot) const {
+        return sectorAddress(sector) + sizeof(SectorHeader) + slot * sizeof(Entry);
+    }
+    
+    bool readSectorHeader(uint32_t sector, SectorHeader& header);
+    bool startSector(uint32_t sector, uint32_t generation, uint32_t firstSequence);
+    bool slotErased(uint32_t sector, uint32_t slot);
+    void flush();
+    void run();
+    
+    template <typename T>
+    static uint32_t crcOf(const T& item);
+};
+
+#endif // AUDIT_LOG_H
@@ -0,0 +1,28 @@
+/**
+ * @file BootTimes.h
+ * @brief Milestones of the staged boot sequence
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * main() brings the board up in order of importance: the lock is driven to
+ * its fail-secure state first, then the keypad starts buffering presses, the
+ * UI thread initialises the LCD in the background and the flash stores open
+ * last. Each stage records the kernel clock (milliseconds since the RTOS
+ * started, a few milliseconds after reset); the console 'boot' command
+ * prints them.
+ */
+
+#ifndef BOOT_TIMES_H
+#define BOOT_TIMES_H
+
+#include <cstdint>
+
+struct BootTimes {
+    uint32_t lockMs;              // Lock in its fail-secure (closed) state
+    uint32_t keypadMs;            // Keypad live, presses are buffered from here
+    uint32_t storeMs;             // PIN store and audit log open
+    uint32_t readyMs;             // Event loop running, buffered keys are handled
+    volatile uint32_t displayMs;  // LCD initialised by the UI thread, 0 = not yet
+};
+
+#endif // BOOT_TIMES_H
@@ -0,0 +1,127 @@
+/**
+ * @file DeadlineScheduler.cpp
+ * @brief Implementation of the deadline-tracking scheduler
+ */
+
+#include "DeadlineScheduler.h"
+
+#include <cstring>
+
+DeadlineScheduler::DeadlineScheduler(Scheduler& base, uint32_t timerDeadlineMs)
+    : _base(base), _taskCount(0), _untracked(0), _checkpoints(0), _failedCheckpoints(0) {
+    memset(_tasks, 0, sizeof(_tasks));
+    memset(_slots, 0, sizeof(_slots));
+    declare("timers", 0, timerDeadlineMs);
+}
+
+// ==================== TASKS ====================
+
+int DeadlineScheduler::declare(const char* name, uint32_t periodMs, uint32_t deadlineMs) {
+    if (_taskCount == DEADLINE_TASKS) {
+        return -1;
+    }
+    TaskStats& stats = _tasks[_taskCount];
+    stats.name = name;
+    stats.periodMs = periodMs;
+    stats.deadlineMs = deadlineMs;
+    return _taskCount++;
+}
+
+void DeadlineScheduler::record(int task, uint32_t lateMs) {
+    if (task < 0 || task >= _taskCount) {
+        return;
+    }
+    TaskStats& stats = _tasks[task];
+    stats.runs++;
+    if (lateMs > stats.worstLateMs) {
+        stats.worstLateMs = lateMs;
+    }
+    if (lateMs > stats.deadlineMs) {
+        stats.overruns++;
+        stats.missed = true;
+    }
+}
+
+bool DeadlineScheduler::checkpoint() {
+    bool met = true;
+    for (int i = 0; i < _taskCount; i++) {
+        met = met && !_tasks[i].missed;
+        _tasks[i].missed = false;
+    }
+    _checkpoints++;
+    _failedCheckpoints += met ? 0 : 1;
+    return met;
+}
+
+void DeadlineScheduler::resetStats() {
+    for (int i = 0; i < _taskCount; i++) {
+        _tasks[i].runs = 0;
+        _tasks[i].overruns = 0;
+        _tasks[i].worstLateMs = 0;
+        _tasks[i].missed = false;
+    }
+    _untracked = 0;
+    _checkpoints = 0;
+    _failedCheckpoints = 0;
+}
+
+// ==================== TIMERS ====================
+
+int DeadlineScheduler::callIn(uint32_t delayMs, Task task, void* context) {
+    return add(delayMs, 0, task, context);
+}
+
+int DeadlineScheduler::callEvery(uint32_t periodMs, Task task, void* context) {
+    return add(periodMs, periodMs, task, context);
+}
+
+int DeadlineScheduler::add(uint32_t delayMs, uint32_t periodMs, Task task, void* context) {
+    for (Slot& slot : _slots) {
+        if (slot.task) {
+            continue;
+        }
+        slot.owner = this;
+        slot.task = task;
+        slot.context = context;
+        slot.dueMs = _base.nowMs() + delayMs;
+        slot.periodMs = periodMs;
+        slot.baseId = periodMs ? _base.callEvery(periodMs, &DeadlineScheduler::fire, &slot)
+                               : _base.callIn(delayMs, &DeadlineScheduler::fire, &slot);
+        return slot.baseId;
+    }
+
+    // Out of slots: still run it, just without the lateness figure
+    _untracked++;
+    return periodMs ? _base.callEvery(periodMs, task, context) : _base.callIn(delayMs, task, context);
+}
+
+void DeadlineScheduler::cancel(int id) {
+    for (Slot& slot : _slots) {
+        if (slot.task && slot.baseId == id) {
+            slot.task = nullptr;
+            break;
+        }
+    }
+    _base.cancel(id);
+}
+
+void DeadlineScheduler::fire(void* context) {
+    Slot& slot = *static_cast<Slot*>(context);
+    if (!slot.task) {
+        return;  // Cancelled after the base had already picked it
+    }
+    DeadlineScheduler& self = *slot.owner;
+
+    int32_t late = static_cast<int32_t>(self._base.nowMs() - slot.dueMs);
+    self.record(TASK_TIMERS, late > 0 ? late : 0);
+
+    // Free or re-arm the slot first: the task may cancel itself or set new timers
+    Task task = slot.task;
+    void* taskContext = slot.context;
+    if (slot.periodMs) {
+        slot.dueMs += slot.periodMs;
+    } else {
+        slot.task = nullptr;
+    }
+    task(taskContext);
+}
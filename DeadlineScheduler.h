@@ -0,0 +1,152 @@
+/**
+ * @file DeadlineScheduler.h
+ * @brief Scheduler that measures how late every task runs
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * The board has no polling loop to time: keys, door timers and screens are
+ * events on the queue and the UI thread. What can go wrong is one of them
+ * running late because something else blocked (a PIN hash, a flash erase, an
+ * I2C stall). This decorator keeps a table of declared tasks, each with a
+ * period and an allowed lateness (its deadline), and counts every run:
+ *
+ * - Timers set through it are tracked automatically as the "timers" task
+ *   (task 0): each run's lateness is the time between its due time and the
+ *   moment the base scheduler ran it. The auto-close therefore fires within
+ *   OPEN_TIME_MS + worstLateMs of the door opening.
+ * - Other tasks (key handling, screen updates) are declared with declare()
+ *   and report their own lateness through record().
+ *
+ * checkpoint() tells whether every task met its deadline since the previous
+ * call; the board feeds the hardware watchdog only then. Runs always count,
+ * overruns are never reset except by resetStats().
+ *
+ * Hardware-free, like TimerWheel: on the board the base is the EventQueue
+ * scheduler, on the host the simulated clock of tests/test_door_sim.cpp. Use
+ * from the thread that runs the tasks.
+ */
+
+#ifndef DEADLINE_SCHEDULER_H
+#define DEADLINE_SCHEDULER_H
+
+#include "DoorIO.h"    // Scheduler
+#include "config.h"
+
+#include <cstdint>
+
+/**
+ * @class DeadlineScheduler
+ * @brief Lateness and overrun bookkeeping on top of a base Scheduler
+ */
+class DeadlineScheduler : public Scheduler {
+public:
+    static const int TASK_TIMERS = 0;
+
+    /**
+     * @brief One declared task
+     */
+    struct TaskStats {
+        const char* name;
+        uint32_t periodMs;          // Expected spacing, 0 = event driven
+        uint32_t deadlineMs;        // Allowed lateness
+        uint32_t runs;
+        uint32_t overruns;          // Runs later than deadlineMs
+        uint32_t worstLateMs;
+        bool missed;                // Overrun since the last checkpoint()
+    };
+
+    /**
+     * @brief Constructor
+     * @param base Scheduler that provides the clock and runs the tasks
+     * @param timerDeadlineMs Allowed lateness of the timers set through this scheduler
+     */
+    explicit DeadlineScheduler(Scheduler& base, uint32_t timerDeadlineMs = DEADLINE_TIMER_MS);
+
+    uint32_t nowMs() override {
+        return _base.nowMs();
+    }
+
+    int callIn(uint32_t delayMs, Task task, void* context) override;
+    int callEvery(uint32_t periodMs, Task task, void* context) override;
+    void cancel(int id) override;
+
+    /**
+     * @brief Add a task that reports its own runs
+     * @return Task index for record(), or -1 if DEADLINE_TASKS are declared
+     */
+    int declare(const char* name, uint32_t periodMs, uint32_t deadlineMs);
+
+    /**
+     * @brief Report one run of a declared task
+     * @param task Index from declare()
+     * @param lateMs Time between when it should have run and when it did
+     */
+    void record(int task, uint32_t lateMs);
+
+    /**
+     * @brief Check and clear the misses since the previous call
+     * @return true if every task met its deadline in between
+     */
+    bool checkpoint();
+
+    /**
+     * @brief Clear every counter (the declarations stay)
+     */
+    void resetStats();
+
+    int taskCount() const {
+        return _taskCount;
+    }
+
+    const TaskStats& task(int index) const {
+        return _tasks[index];
+    }
+
+    /**
+     * @brief Timers that went to the base unmeasured because every slot was in use
+     */
+    uint32_t untracked() const {
+        return _untracked;
+    }
+
+    /**
+     * @brief checkpoint() calls, and those that found a missed deadline
+     */
+    uint32_t checkpoints() const {
+        return _checkpoints;
+    }
+
+    uint32_t failedCheckpoints() const {
+        return _failedCheckpoints;
+    }
+
+private:
+    struct Slot {
+        DeadlineScheduler* owner;
+        Task task;                  // nullptr = free
+        void* context;
+        uint32_t dueMs;
+        uint32_t periodMs;          // 0 = one-shot
+        int baseId;
+    };
+
+    Scheduler& _base;
+    TaskStats _tasks[DEADLINE_TASKS];
+    int _taskCount;
+    Slot _slots[DEADLINE_SLOTS];
+    uint32_t _untracked;
+    uint32_t _checkpoints;
+    uint32_t _failedCheckpoints;
+
+    /**
+     * @brief Take a free slot and hand it to the base
+     */
+    int add(uint32_t delayMs, uint32_t periodMs, Task task, void* context);
+
+    /**
+     * @brief Base task of every tracked timer
+     */
+    static void fire(void* slot);
+};
+
+#endif // DEADLINE_SCHEDULER_H
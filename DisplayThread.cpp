@@ -0,0 +1,113 @@
+/**
+ * @file DisplayThread.cpp
+ * @brief Implementation of the LCD UI thread
+ */
+
+#include "DisplayThread.h"
+#include "Profiler.h"
+
+// ==================== SCREEN ====================
+
+DisplayScreen::DisplayScreen(PCF8574LCD& lcd)
+    : _lcd(lcd), _owner(nullptr), _framebuffer(lcd), _hasPending(false), _pendingSinceMs(0), _worstLatencyMs(0),
+      _backlight(true), _backlightChanged(false), _framesSkipped(0), _framesPresented(0) {
+}
+
+void DisplayScreen::submit(const LCDFrame& frame) {
+    _owner->_mutex.lock();
+    if (_hasPending) {
+        _framesSkipped++;
+    } else {
+        _pendingSinceMs = Kernel::Clock::now().time_since_epoch().count();
+    }
+    _pending = frame;
+    _hasPending = true;
+    _owner->_mutex.unlock();
+    
+    _owner->_flags.set(DisplayThread::FLAG_FRAME);
+}
+
+void DisplayScreen::setBacklight(bool on) {
+    _owner->_mutex.lock();
+    _backlightChanged = _backlightChanged || on != _backlight;
+    _backlight = on;
+    _owner->_mutex.unlock();
+    
+    _owner->_flags.set(DisplayThread::FLAG_FRAME);
+}
+
+void DisplayScreen::service(LCDFrame& frame) {
+    // Take the newest frame and release the lock before touching the bus
+    _owner->_mutex.lock();
+    bool hasFrame = _hasPending;
+    uint32_t submittedMs = _pendingSinceMs;
+    if (hasFrame) {
+        frame = _pending;
+        _hasPending = false;
+    }
+    bool backlightChanged = _backlightChanged;
+    bool backlight = _backlight;
+    _backlightChanged = false;
+    _owner->_mutex.unlock();
+    
+    if (backlightChanged) {
+        _lcd.setBacklight(backlight);
+    }
+    if (hasFrame) {
+        PROFILE_SCOPE("lcd.present");
+        _framebuffer.present(frame);
+        _framesPresented++;
+        
+        uint32_t latency = Kernel::Clock::now().time_since_epoch().count() - submittedMs;
+        _owner->_mutex.lock();
+        _worstLatencyMs = latency > _worstLatencyMs ? latency : _worstLatencyMs;
+        _owner->_mutex.unlock();
+    }
+}
+
+uint32_t DisplayScreen::takeLatencyMs(uint32_t nowMs) {
+    _owner->_mutex.lock();
+    uint32_t worst = _worstLatencyMs;
+    if (_hasPending && nowMs - _pendingSinceMs > worst) {
+        worst = nowMs - _pendingSinceMs;
+    }
+    _worstLatencyMs = 0;
+    _owner->_mutex.unlock();
+    return worst;
+}
+
+// ==================== THREAD ====================
+
+DisplayThread::DisplayThread()
+    : _thread(osPriorityBelowNormal, DISPLAY_THREAD_STACK_SIZE, nullptr, "display"), _screenCount(0) {
+}
+
+bool DisplayThread::addScreen(DisplayScreen& screen) {
+    if (_screenCount == DISPLAY_MAX_SCREENS) {
+        return false;
+    }
+    screen._owner = this;
+    _screens[_screenCount++] = &screen;
+    return true;
+}
+
+void DisplayThread::start(Callback<void()> onReady) {
+    _onReady = onReady;
+    _thread.start(callback(this, &DisplayThread::run));
+}
+
+void DisplayThread::run() {
+    for (int i = 0; i < _screenCount; i++) {
+        _screens[i]->_lcd.init();
+    }
+    if (_onReady) {
+        _onReady();
+    }
+    
+    while (true) {
+        _flags.wait_any(FLAG_FRAME);
+        for (int i = 0; i < _screenCount; i++) {
+            _screens[i]->service(_frame);
+        }
+    }
+}
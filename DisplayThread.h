@@ -0,0 +1,136 @@
+/**
+ * @file DisplayThread.h
+ * @brief UI thread that owns the LCDs and renders submitted frames
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * Application code composes an LCDFrame and calls submit() on the display's
+ * DisplayScreen, which only copies the frame and wakes the UI thread. The UI
+ * thread is the only code that touches the I2C bus, so the door logic and
+ * keypad never wait on a display. If frames arrive faster than a display can
+ * take them, only the newest one is drawn.
+ * 
+ * One thread serves every screen on the bus (up to DISPLAY_MAX_SCREENS, each
+ * backpack at its own PCF8574 address), so extra doors cost a screen object
+ * rather than a thread stack.
+ */
+
+#ifndef DISPLAY_THREAD_H
+#define DISPLAY_THREAD_H
+
+#include "mbed.h"
+#include "LCDFrame.h"
+#include "PCF8574LCD.h"
+#include "DoorIO.h"    // DisplaySink
+#include "config.h"  // DISPLAY_THREAD_STACK_SIZE, DISPLAY_MAX_SCREENS
+
+class DisplayThread;
+
+/**
+ * @class DisplayScreen
+ * @brief One LCD served by a DisplayThread: latest-frame-wins mailbox
+ */
+class DisplayScreen : public DisplaySink {
+public:
+    /**
+     * @brief Constructor
+     * @param lcd Display driver, owned by the UI thread once the screen is added
+     */
+    explicit DisplayScreen(PCF8574LCD& lcd);
+    
+    /**
+     * @brief Queue a frame for display, replacing any frame not yet drawn
+     * Never blocks on the display; safe to call from any thread.
+     * @param frame Screen to show
+     */
+    void submit(const LCDFrame& frame) override;
+    
+    /**
+     * @brief Switch the backlight (applied by the UI thread, never blocks)
+     */
+    void setBacklight(bool on) override;
+    
+    /**
+     * @brief Frames that were replaced before the UI thread drew them
+     */
+    uint32_t framesSkipped() const {
+        return _framesSkipped;
+    }
+    
+    /**
+     * @brief Frames pushed to the display
+     */
+    uint32_t framesPresented() const {
+        return _framesPresented;
+    }
+    
+    /**
+     * @brief Worst time from submit() to drawn since the previous call
+     * A frame still waiting counts with its age so far, so a stuck UI thread shows.
+     * @param nowMs Kernel clock in milliseconds
+     */
+    uint32_t takeLatencyMs(uint32_t nowMs);
+    
+private:
+    friend class DisplayThread;
+    
+    PCF8574LCD& _lcd;
+    DisplayThread* _owner;          // Set by DisplayThread::addScreen()
+    LCDFrameBuffer _framebuffer;    // Used by the UI thread only
+    LCDFrame _pending;              // Guarded by the owner's mutex
+    bool _hasPending;
+    uint32_t _pendingSinceMs;       // First submit() not drawn yet
+    uint32_t _worstLatencyMs;       // Since the last takeLatencyMs(), guarded by the mutex
+    bool _backlight;                // Requested backlight state
+    bool _backlightChanged;         // _backlight not applied yet
+    volatile uint32_t _framesSkipped;
+    volatile uint32_t _framesPresented;
+    
+    /**
+     * @brief UI thread: apply the backlight and draw the pending frame, if any
+     * @param frame Scratch frame (kept off the thread stack)
+     */
+    void service(LCDFrame& frame);
+};
+
+/**
+ * @class DisplayThread
+ * @brief Renderer running in its own thread, shared by every screen on the bus
+ */
+class DisplayThread {
+public:
+    DisplayThread();
+    
+    /**
+     * @brief Register a screen (before start())
+     * @return false if DISPLAY_MAX_SCREENS screens are already registered
+     */
+    bool addScreen(DisplayScreen& screen);
+    
+    /**
+     * @brief Start the UI thread (it initialises every display first)
+     * Returns at once; frames submitted meanwhile are drawn once the displays are up.
+     * @param onReady Called from the UI thread when the displays are initialised
+     */
+    void start(Callback<void()> onReady = nullptr);
+    
+private:
+    friend class DisplayScreen;
+    
+    static const uint32_t FLAG_FRAME = 1;
+    
+    Thread _thread;
+    Mutex _mutex;                   // Guards every screen's pending frame and backlight request
+    EventFlags _flags;
+    Callback<void()> _onReady;
+    DisplayScreen* _screens[DISPLAY_MAX_SCREENS];
+    int _screenCount;
+    LCDFrame _frame;                // Scratch copy of the frame being drawn
+    
+    /**
+     * @brief UI thread body
+     */
+    void run();
+};
+
+#endif // DISPLAY_THREAD_H
@@ -0,0 +1,34 @@
+/**
+ * @file DoorChannel.cpp
+ * @brief Implementation of one door of a multi-door board
+ */
+
+#include "DoorChannel.h"
+
+DoorChannel::DoorChannel(const DoorChannelPins& pins, const char (&keys)[ROWS][COLS], I2C& i2c,
+                         EventQueue& queue, Scheduler& scheduler, AuditSink& audit)
+    : _keypad(keys, pins.rows, pins.cols), _input(_keypad), _lcd(i2c, pins.lcdAddress), _screen(_lcd),
+      _lock(pins.relay, LockDriver::MODE_RELAY), _door(_input, _screen, _lock, scheduler, audit), _queue(queue),
+      _drainPending(false) {
+}
+
+bool DoorChannel::attach(KeypadScanner& scanner, InputThread& input, DisplayThread& display) {
+    if (!input.addChannel(_input)) {
+        return false;
+    }
+    _input.attach(callback(this, &DoorChannel::onKeyEvent));
+    _keypad.attach(callback(&_input, &InputChannel::notify));
+    return scanner.add(_keypad) && display.addScreen(_screen);
+}
+
+void DoorChannel::onKeyEvent() {
+    if (!_drainPending) {
+        _drainPending = true;
+        _queue.call(this, &DoorChannel::drain);
+    }
+}
+
+void DoorChannel::drain() {
+    _drainPending = false;
+    _door.processKeys();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file DoorChannel.h
+ * @brief Everything one door of a multi-door board owns
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * A channel bundles a keypad, an LCD backpack on the shared I2C bus, a relay
+ * LockDriver and the DoorController holding that door's state (input buffer,
+ * attempt counter, timers). There is no per-door LED; the LCD shows the door
+ * state. What the doors share is passed in: the event
+ * queue, one Scheduler (a TimerWheel), the audit log, and - in attach() - the
+ * KeypadScanner, the InputThread and the DisplayThread. main_multidoor.cpp
+ * builds one channel per entry of its pin table.
+ */
+
+#ifndef DOOR_CHANNEL_H
+#define DOOR_CHANNEL_H
+
+#include "mbed.h"
+#include "Keypad.h"
+#include "KeypadScanner.h"
+#include "PCF8574LCD.h"
+#include "DisplayThread.h"
+#include "DoorController.h"
+#include "InputThread.h"
+#include "LockDriver.h"
+#include "config.h"
+
+/**
+ * @brief Pins and bus address of one door
+ */
+struct DoorChannelPins {
+    PinName rows[ROWS];        // Keypad row outputs
+    PinName cols[COLS];        // Keypad column inputs (pull-ups)
+    uint8_t lcdAddress;        // 7-bit PCF8574 address on the shared bus
+    PinName relay;             // Lock relay output (timer channel for the hold PWM), HIGH = open
+};
+
+/**
+ * @class DoorChannel
+ * @brief One door: keypad, LCD, relay and state machine
+ */
+class DoorChannel {
+public:
+    /**
+     * @brief Constructor - the relay is driven closed straight away
+     * @param pins Pins and LCD address of this door
+     * @param keys Keypad layout
+     * @param i2c Bus shared by every door's LCD
+     * @param queue Queue the door logic runs on
+     * @param scheduler Deadlines of every door
+     * @param audit Shared audit log
+     */
+    DoorChannel(const DoorChannelPins& pins, const char (&keys)[ROWS][COLS], I2C& i2c,
+                EventQueue& queue, Scheduler& scheduler, AuditSink& audit);
+    
+    /**
+     * @brief Hand the keypad to the shared scanner and input thread, the LCD to the UI thread
+     * @return false if any of them has no room left
+     */
+    bool attach(KeypadScanner& scanner, InputThread& input, DisplayThread& display);
+    
+    /**
+     * @brief Start the door logic (splash screen, then the password prompt)
+     * @param verifier PIN checker, or nullptr if the PIN store is unusable
+     */
+    void begin(PinVerifier* verifier) {
+        _door.begin(verifier);
+    }
+    
+    DoorController& door() {
+        return _door;
+    }
+    
+    LockDriver& lock() {
+        return _lock;
+    }
+    
+    DisplayScreen& screen() {
+        return _screen;
+    }
+    
+private:
+    Keypad<ROWS, COLS> _keypad;
+    InputChannel _input;               // Keypad events on their way to the door thread
+    PCF8574LCD _lcd;
+    DisplayScreen _screen;
+    LockDriver _lock;
+    DoorController _door;
+    EventQueue& _queue;
+    volatile bool _drainPending;       // drain() already posted
+    
+    /**
+     * @brief Input thread: new events in the mailbox - posts one drain to the queue
+     */
+    void onKeyEvent();
+    
+    /**
+     * @brief Handle every key event queued since the last call (runs on the queue)
+     */
+    void drain();
+};
+
+#endif // DOOR_CHANNEL_H
@@ -0,0 +1,557 @@
+/**
+ * @file DoorController.cpp
+ * @brief Implementation of the door lock state machine
+ */
+
+#include "DoorController.h"
+#include "Profiler.h"
+
+DoorController::DoorController(KeySource& keys, DisplaySink& display, LockActuator& lock,
+                               Scheduler& scheduler, AuditSink& audit)
+    : _keys(keys), _display(display), _lock(lock), _scheduler(scheduler), _audit(audit),
+      _verifier(nullptr), _indicator(nullptr), _stats(nullptr), _settings(&DoorSettings::defaults()), _longPress(nullptr), _longPressContext(nullptr),
+      _state(State::Idle), _failedAttempts(0), _doorOpen(false), _lockedOut(false),
+      _backlightOn(true), _brightnessStep(0), _menuKey(0), _diagPage(0), _openedAtMs(0), _lockedAtMs(0),
+      _openMs(0), _lockoutMs(0),
+      _aPressedUs(0), _feedbackNext(&DoorController::enterRestState),
+      _screenTimeoutId(0), _autoCloseId(0), _lockoutEndId(0), _countdownId(0),
+      _backlightOffId(0) {
+}
+
+void DoorController::setLongPressHandler(Scheduler::Task handler, void* context) {
+    _longPress = handler;
+    _longPressContext = context;
+}
+
+// ==================== STARTUP ====================
+
+void DoorController::begin(PinVerifier* verifier) {
+    _verifier = verifier;
+    closeLock();  // Also shows the fault pattern without a PIN store
+
+    // Keys are accepted straight away; the first one ends the splash screen
+    _frame.clear();
+    _frame.print("Door Lock v1.0");
+    _frame.locate(0, 1);
+    if (!verifier) {
+        _frame.print("PIN store error!");  // Shown even without a splash
+        showFeedback(2000);
+    } else if (BOOT_SPLASH_MS > 0) {
+        _frame.print("System Ready!");
+        showFeedback(BOOT_SPLASH_MS);
+    } else {
+        enterRestState();
+    }
+    scheduleBacklightOff();
+}
+
+// ==================== STATE MACHINE ====================
+
+/**
+ * @brief Cancel a pending task, if any, and forget its id
+ */
+void DoorController::cancel(int& id) {
+    if (id != 0) {
+        _scheduler.cancel(id);
+        id = 0;
+    }
+}
+
+/**
+ * @brief Resting state for the current door and input state
+ */
+DoorController::State DoorController::restState() const {
+    if (_lockedOut) {
+        return State::LockedOut;
+    }
+    if (_doorOpen) {
+        return State::Open;
+    }
+    return _input.empty() ? State::Idle : State::Entering;
+}
+
+/**
+ * @brief Leave any timed screen and show the resting state
+ */
+void DoorController::enterRestState() {
+    cancel(_screenTimeoutId);
+    _state = restState();
+    updateLCD();
+}
+
+/**
+ * @brief Show the frame on screen as a timed message
+ * A key press ends the message early and is handled in the resting state.
+ * @param durationMs How long the message stays up
+ * @param then Called when the time is up (chains the next message)
+ */
+void DoorController::showFeedback(uint32_t durationMs, Step then) {
+    cancel(_screenTimeoutId);
+    _state = State::Feedback;
+    _display.submit(_frame);
+    _feedbackNext = then;
+    _screenTimeoutId = callIn<&DoorController::feedbackDone>(durationMs);
+}
+
+void DoorController::feedbackDone() {
+    _screenTimeoutId = 0;
+    (this->*_feedbackNext)();
+}
+
+/**
+ * @brief Keep the countdown refresh running only while something counts down
+ * One refresh per bar step, so each one changes a single bar cell.
+ */
+void DoorController::updateCountdown() {
+    bool needed = _doorOpen || _lockedOut;
+    if (needed && _countdownId == 0) {
+        uint32_t stepMs = (_lockedOut ? _lockoutMs : _openMs) / (COUNTDOWN_BAR_CELLS * 5);
+        if (stepMs < COUNTDOWN_MIN_STEP_MS) {
+            stepMs = COUNTDOWN_MIN_STEP_MS;
+        }
+        _countdownId = _scheduler.callEvery(stepMs, &DoorController::run<&DoorController::updateLCD>, this);
+    } else if (!needed && _countdownId != 0) {
+        cancel(_countdownId);
+    }
+}
+
+/**
+ * @brief Status light pattern for the door state
+ */
+void DoorController::updateIndicator() {
+    if (!_indicator) {
+        return;
+    }
+    if (_doorOpen) {
+        _indicator->showStatus(StatusIndicator::STATUS_OPEN);
+    } else if (_lockedOut) {
+        _indicator->showStatus(StatusIndicator::STATUS_LOCKOUT);
+    } else if (!_verifier) {
+        _indicator->showStatus(StatusIndicator::STATUS_FAULT);
+    } else {
+        _indicator->showStatus(StatusIndicator::STATUS_CLOSED);
+    }
+}
+
+/**
+ * @brief Seconds left of a period that started at startMs, rounded up
+ * Shows 1 until the period is over, never 0 while it still runs.
+ */
+int DoorController::remainingSeconds(uint32_t startMs, uint32_t durationMs) {
+    return (static_cast<int>(durationMs - (_scheduler.nowMs() - startMs)) + 999) / 1000;
+}
+
+/**
+ * @brief Countdown line: icon, seconds left and a bar that empties with them
+ */
+void DoorController::drawCountdown(Glyph icon, uint32_t startMs, uint32_t durationMs) {
+    uint32_t elapsedMs = _scheduler.nowMs() - startMs;
+    _frame.locate(0, 1);
+    _frame.putGlyph(icon);
+    _frame.printf("%3ds ", remainingSeconds(startMs, durationMs));
+    _frame.bar(COUNTDOWN_BAR_CELLS, elapsedMs < durationMs ? durationMs - elapsedMs : 0, durationMs);
+}
+
+// ==================== POWER MANAGEMENT ====================
+
+/**
+ * @brief Idle timeout: gate the backlight while nothing is going on
+ */
+void DoorController::backlightOff() {
+    _backlightOffId = 0;
+    if (_doorOpen || _lockedOut) {
+        return;  // autoClose()/endLockout() restart the timeout
+    }
+    _backlightOn = false;
+    _display.setBacklight(false);
+}
+
+/**
+ * @brief Backlight on and restart the idle timeout
+ */
+void DoorController::scheduleBacklightOff() {
+    if (!_backlightOn) {
+        _backlightOn = true;
+        _display.setBacklight(true);
+    }
+    cancel(_backlightOffId);
+    _backlightOffId = callIn<&DoorController::backlightOff>(BACKLIGHT_TIMEOUT_MS);
+}
+
+// ==================== LOCK CONTROL ====================
+
+/**
+ * @brief Auto-close deadline (fires exactly openTimeMs after opening)
+ */
+void DoorController::autoClose() {
+    _autoCloseId = 0;
+    closeLock();
+    scheduleBacklightOff();
+    if (_state == State::Open) {
+        enterRestState();
+    } else {
+        updateLCD();  // Live status screen (D) shows the door closed
+    }
+}
+
+/**
+ * @brief Opens the door lock and starts the auto-close deadline
+ */
+void DoorController::openLock() {
+    _doorOpen = true;
+    _lock.setOpen(true);
+
+    _openedAtMs = _scheduler.nowMs();
+    _openMs = _settings->openTimeMs;
+    cancel(_autoCloseId);
+    _autoCloseId = callIn<&DoorController::autoClose>(_openMs);
+    updateCountdown();
+    updateIndicator();
+}
+
+/**
+ * @brief Closes the door lock
+ */
+void DoorController::closeLock() {
+    _doorOpen = false;
+    _lock.setOpen(false);
+
+    cancel(_autoCloseId);
+    updateCountdown();
+    updateIndicator();
+}
+
+// ==================== PASSWORD VALIDATION ====================
+
+/**
+ * @brief Second lockout message, shown after the last "Wrong Password!"
+ */
+void DoorController::showLockoutNotice() {
+    _frame.clear();
+    _frame.print("TOO MANY TRIES!");
+    _frame.locate(0, 1);
+    _frame.printf("Locked %ds", (int)(_lockoutMs / 1000));
+    showFeedback(2000);
+}
+
+/**
+ * @brief Validates entered password and controls access
+ */
+void DoorController::checkPassword() {
+    PROFILE_SCOPE("password.check");
+
+    // Validate password - one constant-time hash table lookup
+    uint16_t userId = AuditSink::NO_USER;
+    bool granted = _verifier
+        ? _verifier->verify(_input.data(), _input.length(), &userId)
+        : _input.matches(PASSWORD);
+    if (granted) {
+        _audit.record(AuditSink::EVENT_ACCESS_GRANTED, 0, userId);
+        // CORRECT PASSWORD
+        _input.clear();
+        _frame.clear();
+        _frame.print("Access Granted!");
+        _frame.locate(0, 1);
+        _frame.print("Door Opening...");
+
+        _failedAttempts = 0;  // Reset failed attempts
+        openLock();
+        showFeedback(2000);
+        return;
+    }
+
+    // WRONG PASSWORD
+    _input.clear();
+    _failedAttempts++;
+    _audit.record(AuditSink::EVENT_ACCESS_DENIED, _failedAttempts);
+    _frame.clear();
+    _frame.print("Wrong Password!");
+    _frame.locate(0, 1);
+    _frame.printf("Attempts: %d/%d", _failedAttempts, _settings->maxFailedAttempts);
+
+    // Check if max attempts reached - the lockout starts now, the
+    // messages only describe it
+    if (_failedAttempts >= _settings->maxFailedAttempts) {
+        _lockedOut = true;
+        _audit.record(AuditSink::EVENT_LOCKOUT);
+        _lockedAtMs = _scheduler.nowMs();
+        _lockoutMs = _settings->lockoutTimeMs;
+        cancel(_lockoutEndId);
+        _lockoutEndId = callIn<&DoorController::endLockout>(_lockoutMs);
+        updateCountdown();
+        updateIndicator();
+        showFeedback(2000, &DoorController::showLockoutNotice);
+    } else {
+        showFeedback(2000);
+    }
+}
+
+// ==================== LCD UPDATE ====================
+
+/**
+ * @brief Updates LCD display based on system state
+ * Timed messages own the screen until they end; the D status screen
+ * keeps its countdown live.
+ */
+void DoorController::updateLCD() {
+    PROFILE_SCOPE("lcd.update");
+
+    if (_state == State::Feedback) {
+        return;
+    }
+    if (_state == State::Menu) {
+        if (_menuKey == 'D') {
+            handleSpecialKeys('D');
+        }
+        return;
+    }
+
+    _frame.clear();
+
+    if (_lockedOut) {
+        _frame.print("LOCKED OUT!");
+        drawCountdown(Glyph::Locked, _lockedAtMs, _lockoutMs);
+    } else if (_doorOpen) {
+        _frame.print("Door Open");
+        drawCountdown(Glyph::Unlocked, _openedAtMs, _openMs);
+    } else {
+        _frame.print("Enter Password:");
+        _frame.locate(0, 1);
+        // Display masked password (asterisks)
+        _frame.repeat('*', _input.length());
+    }
+
+    _display.submit(_frame);
+}
+
+/**
+ * @brief Lockout deadline: accept passwords again
+ */
+void DoorController::endLockout() {
+    _lockoutEndId = 0;
+    _lockedOut = false;
+    _audit.record(AuditSink::EVENT_LOCKOUT_END);
+    _failedAttempts = 0;
+    _input.clear();
+    updateCountdown();
+    updateIndicator();
+    scheduleBacklightOff();
+    if (_state == State::LockedOut) {
+        enterRestState();
+    } else {
+        updateLCD();
+    }
+}
+
+// ==================== SPECIAL KEY HANDLER ====================
+
+/**
+ * @brief Shows the screen for a special key A, B, C, D
+ * The screen stays up for 2-3s (State::Menu) unless another key is pressed.
+ * @param key The special key pressed ('A', 'B', 'C', 'D')
+ */
+void DoorController::handleSpecialKeys(char key) {
+    bool refresh = _state == State::Menu && _menuKey == key;  // Countdown tick, not a key press
+    uint32_t durationMs = 2000;
+    if (!refresh) {
+        _audit.record(AuditSink::EVENT_SPECIAL_KEY, key);
+    }
+
+    switch (key) {
+        case 'A':
+            // A: Display system information, one page per press
+            durationMs = showDiagnostics();
+            break;
+
+        case 'B': {
+            // B: Step the status LED brightness
+            static const uint8_t levels[] = {255, 128, 64, 26};
+            static const uint8_t percent[] = {100, 50, 25, 10};
+            _brightnessStep = (_brightnessStep + 1) % sizeof(levels);
+            if (_indicator) {
+                _indicator->setBrightness(levels[_brightnessStep]);
+            }
+            _frame.clear();
+            _frame.print("LED Brightness");
+            _frame.locate(0, 1);
+            _frame.printf("%d%%", percent[_brightnessStep]);
+            break;
+        }
+
+        case 'C':
+            // C: Clear failed attempts (admin function)
+            _frame.clear();
+            if (_failedAttempts > 0) {
+                _failedAttempts = 0;
+                _frame.print("Attempts Reset");
+            } else {
+                _frame.print("No Attempts");
+            }
+            break;
+
+        case 'D':
+            // D: Display lock status and system state
+            _frame.clear();
+            if (_doorOpen) {
+                _frame.print("Door: OPEN");
+                drawCountdown(Glyph::Unlocked, _openedAtMs, _openMs);
+            } else if (_lockedOut) {
+                _frame.print("Door: LOCKED");
+                drawCountdown(Glyph::Locked, _lockedAtMs, _lockoutMs);
+            } else {
+                _frame.print("Door: CLOSED");
+                _frame.locate(LCD_COLUMNS - 1, 0);
+                _frame.putGlyph(Glyph::Locked);
+                _frame.locate(0, 1);
+                _frame.print("Ready");
+            }
+            durationMs = 3000;
+            break;
+    }
+    _display.submit(_frame);
+
+    if (!refresh) {
+        cancel(_screenTimeoutId);
+        _state = State::Menu;
+        _menuKey = key;
+        _screenTimeoutId = callIn<&DoorController::enterRestState>(durationMs);
+    }
+}
+
+/**
+ * @brief Composes the 'A' page _diagPage (wrapping to the first)
+ * @return How long the page stays up
+ */
+uint32_t DoorController::showDiagnostics() {
+    static const int FIXED_PAGES = 4;  // Version, uptime, CPU, heap
+    SystemStatsSource::Stack stacks[STATS_MAX_THREADS];
+    int stackCount = _stats ? _stats->stacks(stacks, STATS_MAX_THREADS) : 0;
+    if (!_stats || _diagPage >= FIXED_PAGES + stackCount) {
+        _diagPage = 0;
+    }
+
+    SystemStatsSource::Summary stats = {};
+    if (_stats) {
+        _stats->summary(stats);
+    }
+    uint32_t uptimeS = stats.uptimeMs / 1000;
+    uint32_t uptimeMs = stats.uptimeMs ? stats.uptimeMs : 1;
+
+    _frame.clear();
+    switch (_diagPage) {
+        case 0:
+            _frame.print("Door Lock v1.0");
+            _frame.locate(0, 1);
+            _frame.printf("Attempts: %d", _failedAttempts);
+            return 2000;
+
+        case 1:
+            _frame.print("Uptime");
+            _frame.locate(0, 1);
+            _frame.printf("%lud %02lu:%02lu:%02lu", (unsigned long)(uptimeS / 86400),
+                          (unsigned long)(uptimeS / 3600 % 24), (unsigned long)(uptimeS / 60 % 60),
+                          (unsigned long)(uptimeS % 60));
+            break;
+
+        case 2:
+            // Residency since boot; sleep includes deep sleep, idle includes both
+            _frame.print("Idle Slp  Deep");
+            _frame.locate(0, 1);
+            _frame.printf("%3u%% %3u%% %3u%%", (unsigned)((uint64_t)stats.idleMs * 100 / uptimeMs),
+                          (unsigned)((uint64_t)stats.sleepMs * 100 / uptimeMs),
+                          (unsigned)((uint64_t)stats.deepSleepMs * 100 / uptimeMs));
+            break;
+
+        case 3:
+            _frame.printf("Heap %lu/%lu", (unsigned long)stats.heapUsed, (unsigned long)stats.heapSize);
+            _frame.locate(0, 1);
+            _frame.printf("Max %lu Fail %lu", (unsigned long)stats.heapMax, (unsigned long)stats.heapFailures);
+            break;
+
+        default: {
+            const SystemStatsSource::Stack& stack = stacks[_diagPage - FIXED_PAGES];
+            _frame.printf("Stack %.10s", stack.name);
+            _frame.locate(0, 1);
+            _frame.printf("%lu/%lu bytes", (unsigned long)stack.usedBytes, (unsigned long)stack.sizeBytes);
+            break;
+        }
+    }
+    return STATS_PAGE_MS;
+}
+
+// ==================== KEY HANDLER ====================
+
+void DoorController::handleKey(char key) {
+    scheduleBacklightOff();
+
+    // Another 'A' while an 'A' page is up turns to the next page
+    _diagPage = key == 'A' && _state == State::Menu && _menuKey == 'A' ? _diagPage + 1 : 0;
+
+    // A key ends any timed screen and is then handled normally
+    if (_state == State::Feedback || _state == State::Menu) {
+        enterRestState();
+    }
+
+    bool special = key == 'A' || key == 'B' || key == 'C' || key == 'D';
+    if (_state == State::Open) {
+        return;  // Ignore input when door is open
+    }
+    if (_state == State::LockedOut && !special) {
+        return;  // Only the information keys work during a lockout
+    }
+
+    if (key == '#') {
+        // Submit password
+        if (_state == State::Entering) {
+            checkPassword();
+        } else {
+            // No password entered - show message
+            _frame.clear();
+            _frame.print("Enter Password");
+            _frame.locate(0, 1);
+            _frame.print("First!");
+            showFeedback(2000);
+        }
+    } else if (key == '*') {
+        // Clear input with confirmation
+        if (_state == State::Entering) {
+            _input.clear();
+            enterRestState();
+        } else {
+            // No input to clear - show message
+            _frame.clear();
+            _frame.print("Nothing to Clear");
+            showFeedback(1500);
+        }
+    } else if (key >= '0' && key <= '9') {
+        // Add digit to password (max MAX_PASSWORD_LENGTH digits)
+        if (_input.append(key)) {
+            enterRestState();
+        }
+    } else if (special) {
+        // Handle special keys
+        handleSpecialKeys(key);
+    }
+}
+
+void DoorController::processKeys() {
+    PROFILE_SCOPE("key.dispatch");
+
+    KeyEvent event;
+    while (_keys.pollEvent(event)) {
+        if (event.key == 'A') {
+            if (event.type == KeyEvent::Press) {
+                _aPressedUs = event.timestampUs;
+            } else if (event.timestampUs - _aPressedUs >= LONG_PRESS_MS * 1000u && _longPress) {
+                _longPress(_longPressContext);  // Long press of 'A'
+            }
+        }
+        if (event.type != KeyEvent::Press) {
+            continue;
+        }
+        if (event.flags & KeyEvent::FLAG_GHOST) {
+            continue;  // Ambiguous multi-key pattern - could be a phantom key
+        }
+        handleKey(event.key);
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file DoorController.h
+ * @brief Door lock state machine, independent of the hardware
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Password entry, lock timing, lockout, the A-D information screens and the
+ * backlight timeout. Every input and output goes through the interfaces in
+ * DoorIO.h, so the same code runs on the board (main.cpp wires in the drivers)
+ * and on the host under a virtual clock (tests/test_door_sim.cpp).
+ *
+ * All entry points and scheduled tasks must run in one context - on the board
+ * that is the main EventQueue. Nothing here blocks or sleeps.
+ */
+
+#ifndef DOOR_CONTROLLER_H
+#define DOOR_CONTROLLER_H
+
+#include "DoorIO.h"
+#include "DoorSettings.h"
+#include "LCDFrame.h"
+#include "PasswordBuffer.h"
+#include "config.h"
+
+static_assert(sizeof(PASSWORD) - 1 <= MAX_PASSWORD_LENGTH,
+              "PASSWORD is longer than MAX_PASSWORD_LENGTH and could never be entered");
+
+/**
+ * @class DoorController
+ * @brief Keypad-driven door lock logic
+ */
+class DoorController {
+public:
+    /**
+     * @brief Application states
+     * Idle/Entering/Open/LockedOut are resting states derived from the door state;
+     * Feedback and Menu are timed screens that fall back to the resting state.
+     */
+    enum class State {
+        Idle,        // Waiting for the first digit
+        Entering,    // Digits entered, waiting for '#'
+        Feedback,    // Transient message (result, hint) on screen
+        Open,        // Door open, countdown running
+        LockedOut,   // Too many failures, countdown running
+        Menu         // A/B/C/D information screen
+    };
+
+    DoorController(KeySource& keys, DisplaySink& display, LockActuator& lock,
+                   Scheduler& scheduler, AuditSink& audit);
+
+    /**
+     * @brief Engage the lock and show the splash screen (BOOT_SPLASH_MS)
+     * @param verifier PIN checker, or nullptr if the PIN store is unusable
+     *                 (then only the compiled-in PASSWORD opens the door)
+     */
+    void begin(PinVerifier* verifier);
+
+    /**
+     * @brief Status light that follows the door state (optional, before begin())
+     */
+    void setIndicator(StatusIndicator* indicator) {
+        _indicator = indicator;
+    }
+
+    /**
+     * @brief Timing and attempt limits (optional, default DoorSettings::defaults())
+     * Read at every use, so changes apply from the next open, failed PIN or lockout.
+     */
+    void setSettings(const DoorSettings* settings) {
+        _settings = settings;
+    }
+
+    /**
+     * @brief Memory and CPU figures paged through by repeated 'A' presses
+     *        (optional; without it 'A' shows only the version page)
+     */
+    void setStats(SystemStatsSource* stats) {
+        _stats = stats;
+    }
+
+    /**
+     * @brief Called when 'A' is held for LONG_PRESS_MS
+     */
+    void setLongPressHandler(Scheduler::Task handler, void* context);
+
+    /**
+     * @brief Handle every key event queued in the key source
+     */
+    void processKeys();
+
+    /**
+     * @brief Handle one key press in the current state
+     * @param key The pressed key
+     */
+    void handleKey(char key);
+
+    State state() const {
+        return _state;
+    }
+
+    bool isDoorOpen() const {
+        return _doorOpen;
+    }
+
+    bool isLockedOut() const {
+        return _lockedOut;
+    }
+
+    int failedAttempts() const {
+        return _failedAttempts;
+    }
+
+    size_t inputLength() const {
+        return _input.length();
+    }
+
+private:
+    typedef void (DoorController::*Step)();
+
+    // Scheduler tasks are plain functions; this runs a member function instead
+    template <void (DoorController::*Method)()>
+    static void run(void* self) {
+        (static_cast<DoorController*>(self)->*Method)();
+    }
+
+    template <void (DoorController::*Method)()>
+    int callIn(uint32_t delayMs) {
+        return _scheduler.callIn(delayMs, &DoorController::run<Method>, this);
+    }
+
+    void cancel(int& id);
+    State restState() const;
+    void enterRestState();
+    void showFeedback(uint32_t durationMs, Step then = &DoorController::enterRestState);
+    void feedbackDone();
+    void updateCountdown();
+    void updateIndicator();
+    void backlightOff();
+    void scheduleBacklightOff();
+    void autoClose();
+    void openLock();
+    void closeLock();
+    void showLockoutNotice();
+    void checkPassword();
+    void updateLCD();
+    void endLockout();
+    void handleSpecialKeys(char key);
+    uint32_t showDiagnostics();
+    int remainingSeconds(uint32_t startMs, uint32_t durationMs);
+    void drawCountdown(Glyph icon, uint32_t startMs, uint32_t durationMs);
+
+    KeySource& _keys;
+    DisplaySink& _display;
+    LockActuator& _lock;
+    Scheduler& _scheduler;
+    AuditSink& _audit;
+    PinVerifier* _verifier;          // nullptr = only PASSWORD works
+    StatusIndicator* _indicator;     // nullptr = no status light
+    SystemStatsSource* _stats;       // nullptr = no diagnostics pages
+    const DoorSettings* _settings;
+
+    Scheduler::Task _longPress;
+    void* _longPressContext;
+
+    LCDFrame _frame;                 // Screen being composed
+    PasswordBuffer<MAX_PASSWORD_LENGTH> _input;  // User input buffer (no heap)
+    State _state;
+    int _failedAttempts;
+    bool _doorOpen;
+    bool _lockedOut;
+    bool _backlightOn;
+    uint8_t _brightnessStep;         // 'B' steps through the LED brightness levels
+    char _menuKey;                   // Special key whose screen is shown (State::Menu)
+    uint8_t _diagPage;               // 'A' page: version, uptime, CPU, heap, one per thread stack
+    uint32_t _openedAtMs;            // Start of the open period
+    uint32_t _lockedAtMs;            // Start of the lockout
+    uint32_t _openMs;                // Length of the current open period (a setting change waits for the next)
+    uint32_t _lockoutMs;             // Length of the current lockout
+    uint32_t _aPressedUs;            // Start of the current 'A' press
+    Step _feedbackNext;              // Runs when the timed message ends
+
+    // Pending scheduler tasks (0 = none)
+    int _screenTimeoutId;            // Ends Feedback/Menu
+    int _autoCloseId;                // Closes the door after openTimeMs
+    int _lockoutEndId;               // Ends the lockout after lockoutTimeMs
+    int _countdownId;                // Countdown refresh, one bar step, while open/locked out
+    int _backlightOffId;             // Turns the backlight off once idle
+};
+
+#endif // DOOR_CONTROLLER_H
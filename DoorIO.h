@@ -0,0 +1,237 @@
+/**
+ * @file DoorIO.h
+ * @brief Hardware-facing interfaces of the door state machine
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * DoorController only talks to the outside world through these classes. On the
+ * board they are implemented by the Keypad, DisplayScreen, LedEngine, PinStore, AuditLog
+ * and SystemStats drivers plus the small adapters in main.cpp; the host simulation
+ * (tests/test_door_sim.cpp) implements them with fakes and a virtual clock.
+ * Nothing in this file, DoorController or LCDFrame depends on Mbed.
+ */
+
+#ifndef DOOR_IO_H
+#define DOOR_IO_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "KeyEvent.h"
+
+class LCDFrame;
+
+/**
+ * @class KeySource
+ * @brief Queue of debounced key events
+ */
+class KeySource {
+public:
+    /**
+     * @brief Take the oldest queued key event
+     * @param event Receives the event
+     * @return true if an event was available
+     */
+    virtual bool pollEvent(KeyEvent& event) = 0;
+
+protected:
+    ~KeySource() {}
+};
+
+/**
+ * @class DisplaySink
+ * @brief Where finished screens go
+ */
+class DisplaySink {
+public:
+    /**
+     * @brief Show a frame (must not block on the display)
+     */
+    virtual void submit(const LCDFrame& frame) = 0;
+
+    /**
+     * @brief Switch the backlight
+     */
+    virtual void setBacklight(bool on) = 0;
+
+protected:
+    ~DisplaySink() {}
+};
+
+/**
+ * @class LockActuator
+ * @brief Lock output
+ */
+class LockActuator {
+public:
+    /**
+     * @brief Release (true) or engage (false) the lock
+     */
+    virtual void setOpen(bool open) = 0;
+
+protected:
+    ~LockActuator() {}
+};
+
+/**
+ * @class StatusIndicator
+ * @brief Status light showing the door state
+ */
+class StatusIndicator {
+public:
+    enum Status : uint8_t {
+        STATUS_CLOSED,              // Lock engaged, waiting for a PIN
+        STATUS_OPEN,                // Lock released
+        STATUS_LOCKOUT,             // Too many failures
+        STATUS_FAULT                // PIN store unusable
+    };
+
+    /**
+     * @brief Switch to the pattern of a status (takes effect at once)
+     */
+    virtual void showStatus(Status status) = 0;
+
+    /**
+     * @brief Scale every pattern's brightness
+     * @param level 0 (off) to 255 (full)
+     */
+    virtual void setBrightness(uint8_t level) = 0;
+
+protected:
+    ~StatusIndicator() {}
+};
+
+/**
+ * @class Scheduler
+ * @brief Millisecond clock and one-shot/periodic deadlines
+ * Tasks run in the same context as the key handling, one at a time.
+ */
+class Scheduler {
+public:
+    typedef void (*Task)(void* context);
+
+    /**
+     * @brief Monotonic time in milliseconds (wraps after ~49 days)
+     */
+    virtual uint32_t nowMs() = 0;
+
+    /**
+     * @brief Run a task once after a delay
+     * @return Non-zero id for cancel()
+     */
+    virtual int callIn(uint32_t delayMs, Task task, void* context) = 0;
+
+    /**
+     * @brief Run a task every period until cancelled
+     * @return Non-zero id for cancel()
+     */
+    virtual int callEvery(uint32_t periodMs, Task task, void* context) = 0;
+
+    /**
+     * @brief Cancel a pending task (no effect if it already ran)
+     */
+    virtual void cancel(int id) = 0;
+
+protected:
+    ~Scheduler() {}
+};
+
+/**
+ * @class PinVerifier
+ * @brief Checks an entered PIN
+ */
+class PinVerifier {
+public:
+    /**
+     * @brief Check a PIN (constant time)
+     * @param pin Digits, not NUL-terminated
+     * @param length Number of digits
+     * @param userId Set to the owner of the PIN on success (may be nullptr)
+     * @return true if the PIN belongs to a user
+     */
+    virtual bool verify(const char* pin, size_t length, uint16_t* userId = nullptr) = 0;
+
+protected:
+    ~PinVerifier() {}
+};
+
+/**
+ * @class SystemStatsSource
+ * @brief Runtime memory and CPU figures for the diagnostics pages
+ */
+class SystemStatsSource {
+public:
+    /**
+     * @brief Time and heap figures since boot
+     */
+    struct Summary {
+        uint32_t uptimeMs;
+        uint32_t idleMs;            // In the idle thread (includes both sleeps)
+        uint32_t sleepMs;           // Core in sleep (includes deep sleep)
+        uint32_t deepSleepMs;       // Core in deep sleep (STOP mode)
+        uint32_t heapUsed;          // Bytes allocated now
+        uint32_t heapMax;           // High-water mark
+        uint32_t heapSize;          // Bytes reserved for the heap
+        uint32_t heapFailures;      // Allocations that failed
+    };
+
+    /**
+     * @brief Stack usage of one thread
+     */
+    struct Stack {
+        const char* name;           // Thread name (never nullptr)
+        uint32_t usedBytes;         // High-water mark
+        uint32_t sizeBytes;
+    };
+
+    virtual void summary(Summary& out) = 0;
+
+    /**
+     * @brief Stack usage of every thread, up to max
+     * @return Number of entries filled
+     */
+    virtual int stacks(Stack* out, int max) = 0;
+
+protected:
+    ~SystemStatsSource() {}
+};
+
+/**
+ * @class AuditSink
+ * @brief Receiver of security-relevant events
+ */
+class AuditSink {
+public:
+    /**
+     * @brief What happened
+     */
+    enum Event : uint8_t {
+        EVENT_BOOT = 1,
+        EVENT_ACCESS_GRANTED,       // userId = PIN owner
+        EVENT_ACCESS_DENIED,        // arg = failed attempts so far
+        EVENT_LOCKOUT,              // arg = 1 for the console login lockout
+        EVENT_LOCKOUT_END,
+        EVENT_SPECIAL_KEY,          // arg = key ('A'..'D')
+        EVENT_PIN_CHANGED,          // userId = user, from the maintenance console
+        EVENT_PIN_DELETED,
+        EVENT_WATCHDOG_RESET,       // Last reset came from the watchdog (a deadline was missed)
+        EVENT_CONFIG_CHANGED,       // arg = DoorSettings field, 0xFF = all back to defaults
+        EVENT_CONSOLE_DENIED,       // Wrong console login, arg = failed logins so far
+        EVENT_CLOCK_SET             // RTC set on the console: arg = 0 stamped with the old clock, 1 with the new
+    };
+
+    static const uint16_t NO_USER = 0xFFFF;
+
+    /**
+     * @brief Record an event (must not block on storage)
+     * @param event What happened
+     * @param arg Event-specific detail
+     * @param userId User involved, or NO_USER
+     */
+    virtual void record(Event event, uint8_t arg = 0, uint16_t userId = NO_USER) = 0;
+
+protected:
+    ~AuditSink() {}
+};
+
+#endif // DOOR_IO_H
@@ -0,0 +1,82 @@
+/**
+ * @file DoorSettings.cpp
+ * @brief Defaults, ranges and console names of the door settings
+ */
+
+#include "DoorSettings.h"
+#include "config.h"
+
+#include <cstring>
+
+static const DoorSettings DEFAULTS = {
+    OPEN_TIME_MS, LOCKOUT_TIME_MS, MAX_FAILED_ATTEMPTS, DEBOUNCE_TIME_MS, USE_RELAY ? 1 : 0, 0
+};
+
+static_assert(OPEN_TIME_MS >= 1000 && OPEN_TIME_MS <= 600000, "OPEN_TIME_MS outside the settings range");
+static_assert(LOCKOUT_TIME_MS >= 1000 && LOCKOUT_TIME_MS <= 3600000, "LOCKOUT_TIME_MS outside the settings range");
+static_assert(MAX_FAILED_ATTEMPTS >= 1 && MAX_FAILED_ATTEMPTS <= 20, "MAX_FAILED_ATTEMPTS outside the settings range");
+static_assert(DEBOUNCE_TIME_MS >= 4 && DEBOUNCE_TIME_MS <= 100, "DEBOUNCE_TIME_MS outside the settings range");
+
+#define FIELD(name, member, min, max, atBoot) \
+    {name, offsetof(DoorSettings, member), sizeof(DoorSettings::member), min, max, atBoot}
+
+static const DoorSettings::Field FIELDS[] = {
+    FIELD("open_ms",     openTimeMs,        1000, 600000,  false),
+    FIELD("lockout_ms",  lockoutTimeMs,     1000, 3600000, false),
+    FIELD("attempts",    maxFailedAttempts, 1,    20,      false),
+    FIELD("debounce_ms", debounceTimeMs,    4,    100,     false),  // From the next key press
+    FIELD("relay",       useRelay,          0,    1,       true),
+};
+
+#undef FIELD
+
+const DoorSettings& DoorSettings::defaults() {
+    return DEFAULTS;
+}
+
+int DoorSettings::fieldCount() {
+    return sizeof(FIELDS) / sizeof(FIELDS[0]);
+}
+
+const DoorSettings::Field& DoorSettings::field(int index) {
+    return FIELDS[index];
+}
+
+int DoorSettings::find(const char* name) {
+    for (int i = 0; i < fieldCount(); i++) {
+        if (strcmp(FIELDS[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t DoorSettings::get(int index) const {
+    const Field& f = FIELDS[index];
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(this) + f.offset;
+    return f.size == 4 ? *reinterpret_cast<const uint32_t*>(bytes) : *bytes;
+}
+
+bool DoorSettings::set(int index, uint32_t value) {
+    const Field& f = FIELDS[index];
+    if (value < f.min || value > f.max) {
+        return false;
+    }
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(this) + f.offset;
+    if (f.size == 4) {
+        *reinterpret_cast<uint32_t*>(bytes) = value;  // One aligned store
+    } else {
+        *bytes = (uint8_t)value;
+    }
+    return true;
+}
+
+bool DoorSettings::valid() const {
+    for (int i = 0; i < fieldCount(); i++) {
+        uint32_t value = get(i);
+        if (value < FIELDS[i].min || value > FIELDS[i].max) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file DoorSettings.h
+ * @brief Site settings of the door, read by the hot paths as plain fields
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * The values config.h used to fix at build time (OPEN_TIME_MS,
+ * LOCKOUT_TIME_MS, MAX_FAILED_ATTEMPTS, DEBOUNCE_TIME_MS, USE_RELAY) are the
+ * defaults; RuntimeConfig loads the stored values at boot and changes them
+ * live from the maintenance console. The struct is also the stored format:
+ * fields are ordered by size so there is no padding, and new fields go at the
+ * end so a block saved by older firmware still loads (missing fields keep
+ * their defaults).
+ *
+ * Every field is naturally aligned and written with one store, so a door
+ * reading it from another thread sees either the old or the new value.
+ * Hardware-free, so the host simulation runs the door with other settings.
+ */
+
+#ifndef DOOR_SETTINGS_H
+#define DOOR_SETTINGS_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct DoorSettings {
+    uint32_t openTimeMs;            // Door open duration
+    uint32_t lockoutTimeMs;         // Lockout after too many failures
+    uint8_t maxFailedAttempts;      // Wrong PINs before the lockout
+    uint8_t debounceTimeMs;         // Keypad debounce window (scan period is a quarter of it)
+    uint8_t useRelay;               // 1 = relay, 0 = servo (applied at boot)
+    uint8_t reserved;
+
+    /**
+     * @brief One setting as named on the console
+     */
+    struct Field {
+        const char* name;
+        uint8_t offset;
+        uint8_t size;
+        uint32_t min;
+        uint32_t max;
+        bool atBoot;                // Takes effect at the next boot only
+    };
+
+    /**
+     * @brief config.h values
+     */
+    static const DoorSettings& defaults();
+
+    static int fieldCount();
+    static const Field& field(int index);
+
+    /**
+     * @brief Field index by console name, -1 if there is none
+     */
+    static int find(const char* name);
+
+    uint32_t get(int index) const;
+
+    /**
+     * @brief Change one field
+     * @return false (and no change) if the value is outside the field's range
+     */
+    bool set(int index, uint32_t value);
+
+    /**
+     * @brief Every field within its range
+     */
+    bool valid() const;
+};
+
+static_assert(sizeof(DoorSettings) == 12, "DoorSettings is stored as is - keep it free of padding");
+
+#endif // DOOR_SETTINGS_H
@@ -0,0 +1,86 @@
+/**
+ * @file InputThread.cpp
+ * @brief Implementation of the key event input thread
+ */
+
+#include "InputThread.h"
+
+// ==================== CHANNEL ====================
+
+InputChannel::InputChannel(KeySource& source)
+    : _source(source), _owner(nullptr), _flag(0), _stalled(false) {
+}
+
+void InputChannel::notify() {
+    if (_owner) {
+        _owner->_flags.set(_flag);
+    }
+}
+
+bool InputChannel::pollEvent(KeyEvent& event) {
+    KeyEvent* mail = _mail.try_get();
+    if (!mail) {
+        return false;
+    }
+    event = *mail;
+    _mail.free(mail);
+    if (_stalled) {
+        notify();  // A block is free for the held event
+    }
+    return true;
+}
+
+void InputChannel::service() {
+    bool queued = false;
+    while (_stalled || _source.pollEvent(_pending)) {
+        KeyEvent* mail = _mail.try_alloc();
+        if (!mail && !_stalled) {
+            // Door thread behind by INPUT_MAIL_SIZE events: hold this one and
+            // leave the rest in the keypad's ring. Flag first, then look again,
+            // so a block freed in between is not missed
+            _stalled = true;
+            mail = _mail.try_alloc();
+        }
+        if (!mail) {
+            break;
+        }
+        *mail = _pending;
+        _mail.put(mail);
+        _stalled = false;
+        queued = true;
+    }
+    if (queued && _onEvent) {
+        _onEvent();
+    }
+}
+
+// ==================== THREAD ====================
+
+InputThread::InputThread()
+    : _thread(osPriorityAboveNormal, INPUT_THREAD_STACK_SIZE, nullptr, "input"), _channelCount(0) {
+}
+
+bool InputThread::addChannel(InputChannel& channel) {
+    if (_channelCount == INPUT_MAX_CHANNELS) {
+        return false;
+    }
+    channel._flag = 1u << _channelCount;
+    channel._owner = this;
+    _channels[_channelCount++] = &channel;
+    return true;
+}
+
+void InputThread::start() {
+    _thread.start(callback(this, &InputThread::run));
+}
+
+void InputThread::run() {
+    while (true) {
+        uint32_t flags = _flags.wait_any((1u << _channelCount) - 1);
+        for (int i = 0; i < _channelCount; i++) {
+            if (flags & _channels[i]->_flag) {
+                _channels[i]->service();
+            }
+        }
+    }
+}
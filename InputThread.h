@@ -0,0 +1,121 @@
+/**
+ * @file InputThread.h
+ * @brief High-priority thread that moves key events to the door logic
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * The board runs three threads, highest priority first:
+ *
+ * - input (this one, above normal): empties the keypads' interrupt rings into
+ *   preallocated Mail for the door thread and posts one drain per burst
+ * - door (main, normal): the event queue running DoorController - PIN checks,
+ *   lock commands, auto-close and lockout timers
+ * - display (below normal, DisplayThread): the LCDs on the I2C bus
+ *
+ * A keypad's own ring holds KEYPAD_EVENT_QUEUE_SIZE events. The input thread
+ * empties it within a context switch of the scan, even while the door thread
+ * hashes a PIN or the display waits on the bus. Nothing allocates at run time:
+ * the Mail blocks are fixed at INPUT_MAIL_SIZE per keypad. A full mailbox
+ * stops the drain and leaves the rest in the keypad's ring; the door thread
+ * wakes the input thread again when it frees a block, so a Press is never
+ * delivered without its Release. The input thread only copies events, so it
+ * cannot hold up the door timers. The lock motion itself runs from timer
+ * interrupts (LockDriver) and waits on no thread.
+ *
+ * One thread serves every keypad (up to INPUT_MAX_CHANNELS), like the display
+ * thread serves every screen.
+ */
+
+#ifndef INPUT_THREAD_H
+#define INPUT_THREAD_H
+
+#include "mbed.h"
+#include "DoorIO.h"    // KeySource
+#include "KeyEvent.h"
+#include "config.h"  // INPUT_MAIL_SIZE, INPUT_MAX_CHANNELS, INPUT_THREAD_STACK_SIZE
+
+class InputThread;
+
+/**
+ * @class InputChannel
+ * @brief One keypad's events, handed from the input thread to the door thread
+ */
+class InputChannel : public KeySource {
+public:
+    /**
+     * @brief Constructor
+     * @param source Keypad, read by the input thread only once the channel is added
+     */
+    explicit InputChannel(KeySource& source);
+
+    /**
+     * @brief Door thread: next event from the mailbox (restarts a stalled drain)
+     * @return false if the mailbox is empty
+     */
+    bool pollEvent(KeyEvent& event) override;
+
+    /**
+     * @brief Called from the input thread after it queued new events
+     */
+    void attach(Callback<void()> onEvent) {
+        _onEvent = onEvent;
+    }
+
+    /**
+     * @brief Keypad notification (ISR context): wake the input thread for this channel
+     */
+    void notify();
+
+private:
+    friend class InputThread;
+
+    KeySource& _source;
+    InputThread* _owner;            // Set by InputThread::addChannel()
+    uint32_t _flag;                 // This channel's bit in the owner's flags
+    Mail<KeyEvent, INPUT_MAIL_SIZE> _mail;
+    Callback<void()> _onEvent;
+    KeyEvent _pending;              // Taken from the keypad, waiting for a free block
+    volatile bool _stalled;         // _pending is held: the door thread restarts the drain
+
+    /**
+     * @brief Input thread: move the keypad's events into the mailbox, in order
+     */
+    void service();
+};
+
+/**
+ * @class InputThread
+ * @brief Key event pump running above the door thread
+ */
+class InputThread {
+public:
+    InputThread();
+
+    /**
+     * @brief Register a channel (before its keypad is attached to notify())
+     * @return false if INPUT_MAX_CHANNELS channels are already registered
+     */
+    bool addChannel(InputChannel& channel);
+
+    /**
+     * @brief Start the input thread; events notified before are picked up at once
+     */
+    void start();
+
+private:
+    friend class InputChannel;
+
+    static_assert(INPUT_MAX_CHANNELS <= 31, "One event flag per channel, bit 31 is the error bit");
+
+    Thread _thread;
+    EventFlags _flags;              // One bit per channel with events waiting
+    InputChannel* _channels[INPUT_MAX_CHANNELS];
+    int _channelCount;
+
+    /**
+     * @brief Input thread body
+     */
+    void run();
+};
+
+#endif // INPUT_THREAD_H
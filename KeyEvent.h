@@ -0,0 +1,34 @@
+/**
+ * @file KeyEvent.h
+ * @brief Debounced key transition, shared by the keypad driver and the door logic
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Kept free of Mbed headers so the door state machine can be built for the host.
+ */
+
+#ifndef KEY_EVENT_H
+#define KEY_EVENT_H
+
+#include <cstdint>
+
+/**
+ * @struct KeyEvent
+ * @brief A debounced key transition
+ */
+struct KeyEvent {
+    enum Type : uint8_t {
+        Press,
+        Release
+    };
+
+    static const uint8_t FLAG_CHORD = 0x01;    // More than one key down after this event
+    static const uint8_t FLAG_GHOST = 0x02;    // Key pattern may contain phantom keys
+
+    char key;                   // Key character from the layout
+    Type type;                  // Press or release
+    uint8_t flags;              // FLAG_* bits
+    uint32_t timestampUs;       // us_ticker time of the scan that confirmed the transition
+};
+
+#endif // KEY_EVENT_H
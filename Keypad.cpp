@@ -1,97 +1,169 @@
 /**
  * @file Keypad.cpp
- * @brief Implementation of 4x4 Matrix Keypad Library
+ * @brief Implementation of the size-independent keypad logic
  */
 
 #include "Keypad.h"
+#include "Profiler.h"
 
-Keypad::Keypad(char keys[][4], PinName* rowPins, PinName* colPins, int rows, int cols) 
-    : _keys(keys), _rows(rows), _cols(cols), _lastKey('\0') {
+KeypadBase::KeypadBase(const char* layout, int rows, int cols)
+    : _interruptMode(false), _layout(layout), _rows(rows), _cols(cols), _scanning(false),
+      _externalScan(false), _wakeUs(0), _scanPeriodMs(KEYPAD_SCAN_PERIOD_MS) {
+}
+
+void KeypadBase::setInterruptMode(bool enabled) {
+    if (enabled == _interruptMode) {
+        return;
+    }
     
-    // Allocate memory for row pins (outputs)
-    _rowPins = new DigitalOut*[_rows];
-    for (int i = 0; i < _rows; i++) {
-        _rowPins[i] = new DigitalOut(rowPins[i]);
-        _rowPins[i]->write(1);  // Set all rows HIGH initially
+    if (!enabled) {
+        _scanTicker.detach();
+        _scanning = false;
     }
+    _interruptMode = enabled;
     
-    // Allocate memory for column pins (inputs with pull-up)
-    _colPins = new DigitalIn*[_cols];
-    for (int i = 0; i < _cols; i++) {
-        _colPins[i] = new DigitalIn(colPins[i]);
-        _colPins[i]->mode(PullUp);  // Enable internal pull-up resistors
+    attachColumnEdges(enabled);
+    parkRows();
+    
+    // Run one session straight away so a key already held is picked up
+    if (enabled) {
+        core_util_critical_section_enter();
+        onColumnEdge();
+        core_util_critical_section_exit();
+    }
+}
+
+void KeypadBase::onColumnEdge() {
+    if (_scanning) {
+        return;
     }
+    _scanning = true;
+    _wakeUs = us_ticker_read();
+    
+    // Driving the rows toggles the columns - keep those edges out of the ISR
+    // until the session ends
+    setColumnIrqs(false);
+    _scanTicker.attach(callback(this, &KeypadBase::onScanTick),
+                       std::chrono::milliseconds(_scanPeriodMs));
     
-    // Start debounce timer
-    _debounceTimer.start();
+    // First scan right away so press latency is not a whole scan period
+    onScanTick();
+}
+
+bool KeypadBase::scanOnce() {
+    uint16_t raw;
+    {
+        PROFILE_SCOPE("keypad.scan");
+        raw = scanKeys();
+    }
+    return processScan(raw, us_ticker_read());
 }
 
-Keypad::~Keypad() {
-    // Clean up dynamically allocated memory
-    for (int i = 0; i < _rows; i++) {
-        delete _rowPins[i];
+void KeypadBase::onScanTick() {
+    if (scanOnce()) {
+        return;
     }
-    delete[] _rowPins;
     
-    for (int i = 0; i < _cols; i++) {
-        delete _colPins[i];
+    // Idle again: rows are parked LOW, hand over to the column edges
+    _scanTicker.detach();
+    _scanning = false;
+    setColumnIrqs(true);
+}
+
+void KeypadBase::pushEvent(char key, KeyEvent::Type type, uint8_t flags, uint32_t nowUs) {
+    KeyEvent event = {key, type, flags, nowUs};
+    if (_events.push(event)) {
+        _activity.set(EVENT_FLAG);
+        if (_onEvent) {
+            _onEvent();
+        }
     }
-    delete[] _colPins;
 }
 
-char Keypad::scanKeys() {
-    // Scan each row
-    for (int row = 0; row < _rows; row++) {
-        // Set current row LOW, others HIGH
-        for (int i = 0; i < _rows; i++) {
-            _rowPins[i]->write(i == row ? 0 : 1);
+bool KeypadBase::isGhostPattern(uint16_t mask) const {
+    // Without diodes, three corners of a rectangle light up the fourth:
+    // any two rows sharing two or more columns cannot be trusted
+    uint16_t rowMask = (1u << _cols) - 1;
+    for (int r1 = 0; r1 < _rows - 1; r1++) {
+        uint16_t a = (mask >> (r1 * _cols)) & rowMask;
+        if (__builtin_popcount(a) < 2) {
+            continue;
         }
-        
-        // Small delay for signal stabilization
-        wait_us(10);
-        
-        // Check each column
-        for (int col = 0; col < _cols; col++) {
-            // If column is LOW, key is pressed (pull-up makes it HIGH when not pressed)
-            if (_colPins[col]->read() == 0) {
-                // Set all rows back to HIGH
-                for (int i = 0; i < _rows; i++) {
-                    _rowPins[i]->write(1);
-                }
-                return _keys[row][col];
+        for (int r2 = r1 + 1; r2 < _rows; r2++) {
+            uint16_t b = (mask >> (r2 * _cols)) & rowMask;
+            if (__builtin_popcount(a & b) >= 2) {
+                return true;
             }
         }
     }
-    
-    // Set all rows back to HIGH
-    for (int i = 0; i < _rows; i++) {
-        _rowPins[i]->write(1);
-    }
-    
-    return '\0';  // No key pressed
+    return false;
 }
 
-char Keypad::getKey() {
-    char key = scanKeys();
+bool KeypadBase::processScan(uint16_t raw, uint32_t nowUs) {
+    uint16_t toggled = _debouncer.update(raw);
     
-    // Debouncing logic
-    if (key != '\0') {
-        // Key is pressed
-        if (key != _lastKey) {
-            // New key detected
-            _lastKey = key;
-            _debounceTimer.reset();
-            return key;
-        } else {
-            // Same key still pressed - check debounce time
-            if (_debounceTimer.read_ms() > DEBOUNCE_TIME_MS) {
-                return '\0';  // Ignore held key after debounce period
+    if (toggled != 0) {
+        uint16_t state = _debouncer.state();
+        uint8_t flags = 0;
+        if (__builtin_popcount(state) > 1) {
+            flags |= KeyEvent::FLAG_CHORD;
+        }
+        if (isGhostPattern(state)) {
+            flags |= KeyEvent::FLAG_GHOST;
+        }
+        
+        // Releases first, so a rolled-over press is reported after the key it replaced
+        uint16_t released = toggled & ~state;
+        uint16_t pressed = toggled & state;
+        for (int bit = 0; released != 0; bit++, released >>= 1) {
+            if (released & 1) {
+                pushEvent(_layout[bit], KeyEvent::Release, flags, nowUs);
+            }
+        }
+        for (int bit = 0; pressed != 0; bit++, pressed >>= 1) {
+            if (pressed & 1) {
+                pushEvent(_layout[bit], KeyEvent::Press, flags, nowUs);
             }
         }
-    } else {
-        // No key pressed - reset last key
-        _lastKey = '\0';
     }
     
+    return raw != 0 || _debouncer.state() != 0 || _debouncer.settling();
+}
+
+bool KeypadBase::pollEvent(KeyEvent& event) {
+    // Polling mode: the caller's thread is the producer as well
+    if (!_interruptMode && !_externalScan) {
+        scanOnce();
+    }
+    return _events.pop(event);
+}
+
+char KeypadBase::getKey() {
+    KeyEvent event;
+    while (pollEvent(event)) {
+        if (event.type == KeyEvent::Press) {
+            return event.key;
+        }
+    }
     return '\0';
 }
+
+uint32_t KeypadBase::droppedEvents() const {
+    return _events.dropped();
+}
+
+uint16_t KeypadBase::heldKeys() const {
+    return _debouncer.state();
+}
+
+bool KeypadBase::waitForActivity(Kernel::Clock::duration_u32 timeout) {
+    if (!_interruptMode && !_externalScan) {
+        ThisThread::sleep_for(timeout);
+        return true;
+    }
+    
+    if (_events.empty()) {
+        _activity.wait_any_for(EVENT_FLAG, timeout);
+    }
+    return !_events.empty();
+}
@@ -1,11 +1,23 @@
 /**
  * @file Keypad.h
- * @brief 4x4 Matrix Keypad Library for Mbed OS
+ * @brief Matrix Keypad Library for Mbed OS
  * @author Door Locker Project
  * @date 2025
  * 
- * This library provides a simple interface for reading keys from a 4x4 matrix keypad.
- * It uses row-column scanning to detect key presses with debouncing.
+ * This library provides a simple interface for reading keys from a matrix keypad.
+ * The matrix size is a template parameter (4x4, 3x4, 4x3, ...), so the pins live in
+ * std::array members and the scan loops have compile-time bounds.
+ * It scans the whole matrix and debounces every key in parallel, so chords and
+ * rollover are seen instead of only the first key found.
+ * In interrupt mode the rows are parked LOW and a column edge starts a scan
+ * session that runs from a Ticker until the keypad is idle again, so nothing is
+ * scanned while nobody is typing.
+ * Boards with several keypads hand them to a KeypadScanner instead, which
+ * time-slices all of them from one shared Ticker.
+ * When all rows share one GPIO port (and all columns another) the scan drives the
+ * port registers directly: one write and one read per row step.
+ * Press and release events are timestamped and queued in a lock-free ring, so
+ * presses are kept while the application is busy.
  */
 
 #ifndef KEYPAD_H
@@ -13,51 +25,417 @@
 
 #include "mbed.h"
 #include "config.h"  // Include configuration for DEBOUNCE_TIME_MS
+#include "SpscRing.h"
+#include "MatrixDebouncer.h"
+#include "DoorIO.h"    // KeyEvent, KeySource
+
+#include <array>
+#include <utility>
+
+// Port-level scanning needs the HAL port API and STM32 pin encoding (port << 4 | pin)
+#if defined(TARGET_STM) && DEVICE_PORTIN && DEVICE_PORTOUT
+#define KEYPAD_PORT_FASTPATH 1
+#else
+#define KEYPAD_PORT_FASTPATH 0
+#endif
+
+/**
+ * @class KeypadBase
+ * @brief Size-independent part of the keypad: debouncing, scan sessions, event queue
+ * 
+ * Keypad<Rows, Cols> supplies the pins and the matrix scan.
+ */
+class KeypadBase : public KeySource {
+public:
+    /**
+     * @brief Get the next pressed key
+     * Release events are skipped; use pollEvent() to see them.
+     * @return Character of pressed key, or '\0' if no key pressed
+     */
+    char getKey();
+    
+    /**
+     * @brief Take the oldest queued key event
+     * @param event Receives the event
+     * @return true if an event was available
+     */
+    bool pollEvent(KeyEvent& event) override;
+    
+    /**
+     * @brief Number of events lost because the queue was full
+     */
+    uint32_t droppedEvents() const;
+    
+    /**
+     * @brief Debounced state of the whole matrix
+     * @return Bit (row * cols + col) set for every key held down
+     */
+    uint16_t heldKeys() const;
+    
+    /**
+     * @brief Enable or disable interrupt-driven scanning
+     * @param enabled true = scan from a column edge in ISR context,
+     *                false = scan on every getKey()/pollEvent() call
+     */
+    void setInterruptMode(bool enabled);
+    
+    /**
+     * @brief Sleep until a key event is queued or the timeout expires
+     * @param timeout Maximum time to wait (Kernel::wait_for_u32_forever to wait indefinitely)
+     * @return true if an event is ready to be polled
+     */
+    bool waitForActivity(Kernel::Clock::duration_u32 timeout);
+    
+    /**
+     * @brief Register a function called whenever an event is queued
+     * Runs in ISR context in interrupt mode - keep it short (e.g. EventQueue::call()).
+     * @param onEvent Notification callback, or nullptr to remove it
+     */
+    void attach(Callback<void()> onEvent) {
+        _onEvent = onEvent;
+    }
+    
+    /**
+     * @brief Change the debounce window (any thread, applies from the next scan session)
+     * The debouncer wants four stable scans, so the scan period is a quarter of it.
+     * @param ms Debounce time, DEBOUNCE_TIME_MS at construction
+     */
+    void setDebounceTime(uint32_t ms) {
+        _scanPeriodMs = ms >= 4 ? ms / 4 : 1;
+    }
+    
+    /**
+     * @brief Time (us_ticker) of the column edge that started the latest scan session
+     * Press latency is an event's timestampUs minus this.
+     */
+    uint32_t lastWakeUs() const {
+        return _wakeUs;
+    }
+    
+    /**
+     * @brief Check which scan backend is in use
+     * @return true if rows/columns are driven through port registers
+     */
+    virtual bool usesPortScan() const = 0;
+    
+protected:
+    /**
+     * @brief Constructor for the shared part
+     * @param layout Key characters, row-major, rows * cols entries
+     * @param rows Number of rows
+     * @param cols Number of columns
+     */
+    KeypadBase(const char* layout, int rows, int cols);
+    
+    virtual ~KeypadBase() {}
+    
+    /**
+     * @brief Scan the keypad matrix and park the rows again
+     * @return Raw key bits (row * cols + col), set = key reads as down
+     */
+    virtual uint16_t scanKeys() = 0;
+    
+    /**
+     * @brief Drive every row to the idle level (LOW in interrupt mode, HIGH otherwise)
+     */
+    virtual void parkRows() = 0;
+    
+    /**
+     * @brief Enable or disable the column edge interrupts
+     */
+    virtual void setColumnIrqs(bool enabled) = 0;
+    
+    /**
+     * @brief Attach (or detach) onColumnEdge() on both edges of every column
+     */
+    virtual void attachColumnEdges(bool attach) = 0;
+    
+    /**
+     * @brief Column edge ISR - starts a scan session
+     */
+    void onColumnEdge();
+    
+    bool _interruptMode;        // Rows parked LOW, scan on column edge
+    
+private:
+    friend class KeypadScanner;
+    
+
+    const char* _layout;        // Key characters, row-major
+    const int _rows;            // Number of rows
+    const int _cols;            // Number of columns
+    volatile bool _scanning;    // Scan session running on _scanTicker
+    bool _externalScan;         // Scanned by a KeypadScanner, not by pollEvent()
+    volatile uint32_t _wakeUs;  // Start of the current scan session
+    volatile uint32_t _scanPeriodMs;  // Scan session tick, a quarter of the debounce time
+    Ticker _scanTicker;         // Rescans while a key is active
+    EventFlags _activity;       // Set whenever an event is queued
+    Callback<void()> _onEvent;  // Event notification (see attach())
+    MatrixDebouncer _debouncer; // Debounced state of every key
+    SpscRing<KeyEvent, KEYPAD_EVENT_QUEUE_SIZE> _events;
+    
+    static const uint32_t EVENT_FLAG = 0x1;
+    
+    /**
+     * @brief Scan the matrix once and debounce the result
+     * @return true while a key is held or still settling
+     */
+    bool scanOnce();
+    
+    /**
+     * @brief Debounce one scan result and queue any transitions
+     * @param raw Result of scanKeys()
+     * @param nowUs Time of the scan
+     * @return true while a key is held or still settling
+     */
+    bool processScan(uint16_t raw, uint32_t nowUs);
+    
+    /**
+     * @brief Check a key pattern for a rectangle that a diode-less matrix can fake
+     */
+    bool isGhostPattern(uint16_t mask) const;
+    
+    /**
+     * @brief Queue an event, wake waitForActivity() and notify the attached callback
+     */
+    void pushEvent(char key, KeyEvent::Type type, uint8_t flags, uint32_t nowUs);
+    
+    /**
+     * @brief Scan ticker ISR - one scan, ends the session once idle
+     */
+    void onScanTick();
+};
 
 /**
  * @class Keypad
  * @brief Matrix keypad scanner with debouncing
+ * @tparam Rows Number of rows
+ * @tparam Cols Number of columns
  */
-class Keypad {
+template <int Rows = ROWS, int Cols = COLS>
+class Keypad : public KeypadBase {
+    static_assert(Rows > 0 && Cols > 0 && Rows * Cols <= 16,
+                  "Keypad supports up to 16 keys (one debouncer bit each)");
+    
 public:
     /**
      * @brief Constructor for Keypad
      * @param keys 2D array of key characters (rows x cols)
      * @param rowPins Array of row pin names
      * @param colPins Array of column pin names
-     * @param rows Number of rows
-     * @param cols Number of columns
      */
-    Keypad(char keys[][4], PinName* rowPins, PinName* colPins, int rows, int cols);
+    Keypad(const char (&keys)[Rows][Cols], const PinName (&rowPins)[Rows],
+           const PinName (&colPins)[Cols])
+        : Keypad(keys, rowPins, colPins, std::make_index_sequence<Rows>(),
+                 std::make_index_sequence<Cols>()) {}
     
     /**
      * @brief Destructor
      */
-    ~Keypad();
+    ~Keypad() {
+        setInterruptMode(false);
+    }
+    
+    bool usesPortScan() const override;
+    
+protected:
+    uint16_t scanKeys() override;
+    void parkRows() override;
+    void setColumnIrqs(bool enabled) override;
+    void attachColumnEdges(bool attach) override;
+    
+private:
+    std::array<DigitalOut, Rows> _rowPins;      // Row outputs (per-pin fallback)
+    std::array<InterruptIn, Cols> _colPins;     // Column inputs, one edge IRQ each
+    
+#if KEYPAD_PORT_FASTPATH
+    bool _usePorts;                             // Both pin groups fit on one port each
+    port_t _rowPort;                            // Row outputs
+    port_t _colPort;                            // Column inputs
+    uint16_t _rowMask;                          // All row bits on _rowPort
+    std::array<uint16_t, Rows> _rowBits;        // Port bit per row
+    std::array<uint16_t, Cols> _colBits;        // Port bit per column
     
     /**
-     * @brief Get the currently pressed key
-     * @return Character of pressed key, or '\0' if no key pressed
+     * @brief Set up the port backend if both pin groups share a port
+     * @return true if the port backend is usable
      */
-    char getKey();
+    bool initPorts(const PinName (&rowPins)[Rows], const PinName (&colPins)[Cols]);
     
-private:
-    char (*_keys)[4];           // Pointer to key mapping array
-    DigitalOut** _rowPins;      // Array of row output pins
-    DigitalIn** _colPins;       // Array of column input pins
-    int _rows;                  // Number of rows
-    int _cols;                  // Number of columns
-    char _lastKey;              // Last detected key
-    Timer _debounceTimer;       // Timer for debouncing
+    /**
+     * @brief Matrix scan through the port registers
+     * @return Raw key bits, set = column read LOW
+     */
+    uint16_t scanPorts();
+#endif
     
-    // Use DEBOUNCE_TIME_MS from config.h
-    static const int DEBOUNCE_TIME_MS = ::DEBOUNCE_TIME_MS;
+    /**
+     * @brief Build the pin arrays element by element (the pin classes are not copyable)
+     */
+    template <size_t... R, size_t... C>
+    Keypad(const char (&keys)[Rows][Cols], const PinName (&rowPins)[Rows],
+           const PinName (&colPins)[Cols], std::index_sequence<R...>, std::index_sequence<C...>);
     
     /**
-     * @brief Scan the keypad matrix
-     * @return Character of pressed key, or '\0' if none
+     * @brief Matrix scan through the per-pin DigitalOut/InterruptIn objects
+     * @return Raw key bits, set = column read LOW
      */
-    char scanKeys();
+    uint16_t scanPins();
 };
 
+// ==================== TEMPLATE IMPLEMENTATION ====================
+
+template <int Rows, int Cols>
+template <size_t... R, size_t... C>
+Keypad<Rows, Cols>::Keypad(const char (&keys)[Rows][Cols], const PinName (&rowPins)[Rows],
+                           const PinName (&colPins)[Cols], std::index_sequence<R...>,
+                           std::index_sequence<C...>)
+    : KeypadBase(&keys[0][0], Rows, Cols),
+      _rowPins{{ {rowPins[R]}... }},
+      _colPins{{ {colPins[C], PullUp}... }} {  // Internal pull-ups on the columns
+#if KEYPAD_PORT_FASTPATH
+    _usePorts = initPorts(rowPins, colPins);
+#endif
+    parkRows();  // Set all rows HIGH initially
+}
+
+#if KEYPAD_PORT_FASTPATH
+template <int Rows, int Cols>
+bool Keypad<Rows, Cols>::initPorts(const PinName (&rowPins)[Rows], const PinName (&colPins)[Cols]) {
+    uint32_t rowPort = STM_PORT(rowPins[0]);
+    uint32_t colPort = STM_PORT(colPins[0]);
+    uint16_t colMask = 0;
+    _rowMask = 0;
+    
+    for (int i = 0; i < Rows; i++) {
+        if (rowPins[i] == NC || STM_PORT(rowPins[i]) != rowPort) {
+            return false;
+        }
+        _rowBits[i] = 1u << STM_PIN(rowPins[i]);
+        _rowMask |= _rowBits[i];
+    }
+    for (int i = 0; i < Cols; i++) {
+        if (colPins[i] == NC || STM_PORT(colPins[i]) != colPort) {
+            return false;
+        }
+        _colBits[i] = 1u << STM_PIN(colPins[i]);
+        colMask |= _colBits[i];
+    }
+    
+    port_init(&_rowPort, (PortName)rowPort, _rowMask, PIN_OUTPUT);
+    
+    // port_init() reconfigures the pins without pulls - restore the pull-ups
+    port_init(&_colPort, (PortName)colPort, colMask, PIN_INPUT);
+    port_mode(&_colPort, PullUp);
+    return true;
+}
+
+template <int Rows, int Cols>
+uint16_t Keypad<Rows, Cols>::scanPorts() {
+    uint16_t raw = 0;
+    
+    // One register write selects the row, one read samples every column
+    for (int row = 0; row < Rows; row++) {
+        port_write(&_rowPort, _rowMask & ~_rowBits[row]);
+        wait_us(10);
+        uint32_t levels = port_read(&_colPort);
+        
+        for (int col = 0; col < Cols; col++) {
+            if ((levels & _colBits[col]) == 0) {
+                raw |= 1u << (row * Cols + col);
+            }
+        }
+    }
+    
+    return raw;
+}
+#endif
+
+template <int Rows, int Cols>
+bool Keypad<Rows, Cols>::usesPortScan() const {
+#if KEYPAD_PORT_FASTPATH
+    return _usePorts;
+#else
+    return false;
+#endif
+}
+
+template <int Rows, int Cols>
+void Keypad<Rows, Cols>::parkRows() {
+    int idle = _interruptMode ? 0 : 1;
+#if KEYPAD_PORT_FASTPATH
+    if (_usePorts) {
+        port_write(&_rowPort, idle ? _rowMask : 0);
+        return;
+    }
+#endif
+    for (int i = 0; i < Rows; i++) {
+        _rowPins[i].write(idle);
+    }
+}
+
+template <int Rows, int Cols>
+void Keypad<Rows, Cols>::setColumnIrqs(bool enabled) {
+    for (int i = 0; i < Cols; i++) {
+        if (enabled) {
+            _colPins[i].enable_irq();
+        } else {
+            _colPins[i].disable_irq();
+        }
+    }
+}
+
+template <int Rows, int Cols>
+void Keypad<Rows, Cols>::attachColumnEdges(bool attach) {
+    for (int i = 0; i < Cols; i++) {
+        if (attach) {
+            // Press pulls a column LOW, release lets it float back HIGH
+            _colPins[i].fall(callback(this, &Keypad::onColumnEdge));
+            _colPins[i].rise(callback(this, &Keypad::onColumnEdge));
+        } else {
+            _colPins[i].fall(nullptr);
+            _colPins[i].rise(nullptr);
+        }
+    }
+}
+
+template <int Rows, int Cols>
+uint16_t Keypad<Rows, Cols>::scanPins() {
+    uint16_t raw = 0;
+    
+    // Scan each row
+    for (int row = 0; row < Rows; row++) {
+        // Set current row LOW, others HIGH
+        for (int i = 0; i < Rows; i++) {
+            _rowPins[i].write(i == row ? 0 : 1);
+        }
+        
+        // Small delay for signal stabilization
+        wait_us(10);
+        
+        // Check each column
+        for (int col = 0; col < Cols; col++) {
+            // If column is LOW, key is pressed (pull-up makes it HIGH when not pressed)
+            if (_colPins[col].read() == 0) {
+                raw |= 1u << (row * Cols + col);
+            }
+        }
+    }
+    
+    return raw;
+}
+
+template <int Rows, int Cols>
+uint16_t Keypad<Rows, Cols>::scanKeys() {
+#if KEYPAD_PORT_FASTPATH
+    uint16_t raw = _usePorts ? scanPorts() : scanPins();
+#else
+    uint16_t raw = scanPins();
+#endif
+    
+    // Return rows to their idle level
+    parkRows();
+    return raw;
+}
+
 #endif // KEYPAD_H
@@ -0,0 +1,46 @@
+/**
+ * @file KeypadScanner.cpp
+ * @brief Implementation of the shared keypad scan scheduler
+ */
+
+#include "KeypadScanner.h"
+
+KeypadScanner::KeypadScanner() : _count(0), _next(0), _periodMs(KEYPAD_SCAN_PERIOD_MS), _running(false) {
+}
+
+bool KeypadScanner::add(KeypadBase& keypad) {
+    if (_count == KEYPAD_SCANNER_MAX) {
+        return false;
+    }
+    keypad.setInterruptMode(false);
+    keypad._externalScan = true;
+    _keypads[_count++] = &keypad;
+    return true;
+}
+
+void KeypadScanner::start() {
+    if (_count == 0) {
+        return;
+    }
+    _next = 0;
+    _running = true;
+    _ticker.attach(callback(this, &KeypadScanner::onTick),
+                   std::chrono::microseconds(_periodMs * 1000 / _count));
+}
+
+void KeypadScanner::stop() {
+    _running = false;
+    _ticker.detach();
+}
+
+void KeypadScanner::setDebounceTime(uint32_t ms) {
+    _periodMs = ms >= 4 ? ms / 4 : 1;
+    if (_running) {
+        start();
+    }
+}
+
+void KeypadScanner::onTick() {
+    _keypads[_next]->scanOnce();
+    _next = _next + 1 < _count ? _next + 1 : 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file KeypadScanner.h
+ * @brief One Ticker that time-slices the scans of several keypads
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * A board with one keypad per door cannot give every keypad its own column
+ * interrupts (the STM32 has one EXTI line per pin number) nor its own ticker
+ * without paying for it in timer events. The scanner scans one keypad per tick,
+ * round robin, with the tick period divided by the number of keypads, so each
+ * keypad is still scanned every quarter of the debounce time and a press is
+ * reported after the usual debounce time plus at most one period.
+ *
+ * Scanning runs continuously, so the core does not reach STOP mode; the
+ * single-door build keeps the interrupt-driven keypad.
+ */
+
+#ifndef KEYPAD_SCANNER_H
+#define KEYPAD_SCANNER_H
+
+#include "mbed.h"
+#include "Keypad.h"
+#include "config.h"
+
+/**
+ * @class KeypadScanner
+ * @brief Round-robin scan scheduler for up to KEYPAD_SCANNER_MAX keypads
+ */
+class KeypadScanner {
+public:
+    KeypadScanner();
+    
+    /**
+     * @brief Hand a keypad over to the scanner (before start())
+     * Its events are queued as usual; pollEvent() no longer scans it.
+     * @return false if KEYPAD_SCANNER_MAX keypads are already added
+     */
+    bool add(KeypadBase& keypad);
+    
+    /**
+     * @brief Start the shared scan ticker
+     */
+    void start();
+    
+    /**
+     * @brief Stop scanning (queued events stay available)
+     */
+    void stop();
+    
+    /**
+     * @brief Change the debounce window of every keypad (restarts a running ticker)
+     * @param ms Debounce time, DEBOUNCE_TIME_MS at construction
+     */
+    void setDebounceTime(uint32_t ms);
+    
+    int count() const {
+        return _count;
+    }
+    
+private:
+    KeypadBase* _keypads[KEYPAD_SCANNER_MAX];
+    int _count;
+    int _next;                  // Keypad scanned on the next tick
+    uint32_t _periodMs;         // Scan period of each keypad
+    bool _running;
+    Ticker _ticker;
+    
+    /**
+     * @brief Ticker ISR - scans one keypad
+     */
+    void onTick();
+};
+
+#endif // KEYPAD_SCANNER_H
@@ -0,0 +1,94 @@
+/**
+ * @file LCDFrame.cpp
+ * @brief Implementation of the LCD frame (no display driver, part of the host build)
+ */
+
+#include "LCDFrame.h"
+
+#include <cstdarg>
+#include <cstring>
+
+// ==================== LCDFrame ====================
+
+LCDFrame::LCDFrame() {
+    clear();
+}
+
+void LCDFrame::clear() {
+    memset(_cells, ' ', sizeof(_cells));
+    _column = 0;
+    _row = 0;
+}
+
+void LCDFrame::locate(int column, int row) {
+    _column = column;
+    _row = row;
+}
+
+void LCDFrame::putc(char c) {
+    if (_row < 0 || _row >= LCD_LINES || _column < 0 || _column >= LCD_COLUMNS) {
+        return;
+    }
+    _cells[_row][_column++] = c;
+}
+
+void LCDFrame::print(const char* text) {
+    while (*text) {
+        putc(*text++);
+    }
+}
+
+void LCDFrame::repeat(char c, int count) {
+    while (count-- > 0) {
+        putc(c);
+    }
+}
+
+void LCDFrame::putGlyph(Glyph glyph) {
+    putc(glyphCode(glyph));
+}
+
+void LCDFrame::bar(int width, uint32_t value, uint32_t maximum) {
+    if (width <= 0 || maximum == 0) {
+        return;
+    }
+    if (value > maximum) {
+        value = maximum;
+    }
+    // Rounded up, so the bar only empties when value reaches 0
+    uint32_t steps = static_cast<uint32_t>(width) * 5;
+    uint32_t lit = static_cast<uint32_t>(((uint64_t)value * steps + maximum - 1) / maximum);
+    for (int i = 0; i < width; i++, lit = lit > 5 ? lit - 5 : 0) {
+        if (lit >= 5) {
+            putc(GLYPH_FULL_BLOCK);
+        } else if (lit > 0) {
+            putGlyph(static_cast<Glyph>(static_cast<int>(Glyph::Bar1) + lit - 1));
+        } else {
+            putc(' ');
+        }
+    }
+}
+
+const uint8_t* LCDFrame::glyphRows(Glyph glyph) {
+    static const uint8_t rows[static_cast<int>(Glyph::Count)][GLYPH_ROWS] = {
+        {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},  // Bar1: full height, like GLYPH_FULL_BLOCK
+        {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+        {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+        {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+        {0x0E, 0x11, 0x11, 0x1F, 0x1B, 0x1B, 0x1F, 0x00},  // Locked: closed shackle
+        {0x0E, 0x10, 0x10, 0x1F, 0x1B, 0x1B, 0x1F, 0x00},  // Unlocked: shackle open on the right
+    };
+    return rows[static_cast<int>(glyph)];
+}
+
+static void putCell(void* frame, char c) {
+    static_cast<LCDFrame*>(frame)->putc(c);
+}
+
+int LCDFrame::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int len = tinyVFormat(&putCell, this, format, args);
+    va_end(args);
+    return len;
+}
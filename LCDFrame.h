@@ -0,0 +1,201 @@
+/**
+ * @file LCDFrame.h
+ * @brief Off-screen LCD frame and shadow framebuffer for character LCDs
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * Screens are composed into an LCDFrame and handed to LCDFrameBuffer::present(),
+ * which compares them with a shadow copy of what the display already shows and
+ * only sends the cells that changed. No clear command is ever sent, so there is
+ * no flicker, and a countdown tick costs one or two characters on the bus. Each
+ * run of adjacent changed cells goes out as a single PCF8574LCD burst.
+ * 
+ * Frames can also hold custom glyphs (progress bar blocks, lock icons). A glyph
+ * cell stores GLYPH_CODE_BASE + glyph, a range the HD44780 ROM leaves blank.
+ * LCDFrameBuffer keeps glyphs in the eight CGRAM slots: each one is uploaded the
+ * first time a frame uses it, and its slot number goes out in its place.
+ */
+
+#ifndef LCD_FRAME_H
+#define LCD_FRAME_H
+
+#include <cstdint>
+
+#include "TinyFormat.h"
+#include "config.h"  // LCD_COLUMNS, LCD_LINES
+
+class PCF8574LCD;
+
+/**
+ * @brief Custom characters a frame can show
+ */
+enum class Glyph : uint8_t {
+    Bar1,           // Progress bar cell, 1 of 5 pixel columns lit
+    Bar2,
+    Bar3,
+    Bar4,
+    Locked,
+    Unlocked,
+    Count
+};
+
+static const char GLYPH_CODE_BASE = 0x10;       // Cell code of the first glyph
+static const char GLYPH_FULL_BLOCK = '\xFF';    // ROM character with every pixel lit
+static const int GLYPH_ROWS = 8;                // 5x8 font
+
+/**
+ * @class LCDFrame
+ * @brief One screen worth of characters with a write cursor
+ */
+class LCDFrame {
+public:
+    LCDFrame();
+    
+    /**
+     * @brief Blank every cell and move the cursor home
+     */
+    void clear();
+    
+    /**
+     * @brief Move the write cursor
+     * @param column Column (0 = left)
+     * @param row Line (0 = top)
+     */
+    void locate(int column, int row);
+    
+    /**
+     * @brief Write one character at the cursor and advance it
+     * Characters past the end of the line are dropped.
+     */
+    void putc(char c);
+    
+    /**
+     * @brief Write a string at the cursor
+     */
+    void print(const char* text);
+    
+    /**
+     * @brief Write a character count times (password masking)
+     */
+    void repeat(char c, int count);
+    
+    /**
+     * @brief Formatted write at the cursor, straight into the cells
+     * TinyFormat subset: %d %u %x %c %s, width, '-' and '0' flags.
+     * @return Number of characters produced
+     */
+    int printf(const char* format, ...) TINY_FORMAT_CHECK(2, 3);
+    
+    /**
+     * @brief Write a custom glyph at the cursor and advance it
+     */
+    void putGlyph(Glyph glyph);
+    
+    /**
+     * @brief Draw a horizontal bar at the cursor
+     * Each cell has five pixel columns, so the bar moves in width * 5 steps;
+     * the lit part is value / maximum of it, rounded up.
+     * @param width Cells the bar takes
+     * @param value Lit amount, clipped to maximum
+     * @param maximum Amount of a full bar
+     */
+    void bar(int width, uint32_t value, uint32_t maximum);
+    
+    /**
+     * @brief Character stored in a cell
+     */
+    char at(int column, int row) const {
+        return _cells[row][column];
+    }
+    
+    /**
+     * @brief Cell code of a glyph
+     */
+    static char glyphCode(Glyph glyph) {
+        return static_cast<char>(GLYPH_CODE_BASE + static_cast<int>(glyph));
+    }
+    
+    /**
+     * @brief Does a cell hold a glyph rather than a ROM character?
+     */
+    static bool isGlyph(char c) {
+        return c >= GLYPH_CODE_BASE && c < GLYPH_CODE_BASE + static_cast<int>(Glyph::Count);
+    }
+    
+    /**
+     * @brief Pixel rows of a glyph, top first, five low bits per row
+     */
+    static const uint8_t* glyphRows(Glyph glyph);
+    
+private:
+    char _cells[LCD_LINES][LCD_COLUMNS];
+    int _column;
+    int _row;
+};
+
+/**
+ * @class LCDFrameBuffer
+ * @brief Pushes frames to the display, sending only changed cells
+ */
+class LCDFrameBuffer {
+public:
+    /**
+     * @brief Constructor
+     * @param lcd Display the frames are written to
+     */
+    explicit LCDFrameBuffer(PCF8574LCD& lcd);
+    
+    /**
+     * @brief Bring the display in line with a frame
+     * If a burst is lost on the bus, the next call rewrites the whole screen.
+     * @param frame Screen to show
+     */
+    void present(const LCDFrame& frame);
+    
+    /**
+     * @brief Forget the shadow copy so the next present() rewrites every cell
+     */
+    void invalidate();
+    
+    /**
+     * @brief Total number of characters sent to the display
+     */
+    uint32_t cellsWritten() const {
+        return _cellsWritten;
+    }
+    
+    /**
+     * @brief Glyphs uploaded into CGRAM
+     */
+    uint32_t glyphUploads() const {
+        return _glyphUploads;
+    }
+    
+private:
+    static const int CGRAM_SLOTS = 8;
+    static const int8_t SLOT_FREE = -1;
+    
+    PCF8574LCD& _lcd;
+    LCDFrame _shadow;           // What the display currently shows
+    bool _valid;                // _shadow matches the display
+    uint32_t _cellsWritten;
+    int8_t _slotGlyph[CGRAM_SLOTS];     // Glyph in each CGRAM slot, SLOT_FREE if none
+    uint32_t _slotUsed[CGRAM_SLOTS];    // present() that last used it, oldest goes first
+    uint32_t _presents;
+    uint32_t _glyphUploads;
+    
+    /**
+     * @brief Bitmask of the glyphs on a frame
+     */
+    static uint32_t glyphsIn(const LCDFrame& frame);
+    
+    /**
+     * @brief Display code for a frame cell, uploading its glyph if CGRAM lacks it
+     * @param c Frame cell
+     * @param keep Glyphs whose slots must stay (they are on the incoming frame)
+     * @param shown Glyphs on the display, replaced only when no other slot is left
+     */
+    char resolve(char c, uint32_t keep, uint32_t shown);
+};
+
+#endif // LCD_FRAME_H
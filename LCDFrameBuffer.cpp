@@ -0,0 +1,117 @@
+/**
+ * @file LCDFrameBuffer.cpp
+ * @brief Implementation of the shadow framebuffer (needs the display driver, not in the host build)
+ */
+
+#include "LCDFrame.h"
+#include "PCF8574LCD.h"
+
+LCDFrameBuffer::LCDFrameBuffer(PCF8574LCD& lcd)
+    : _lcd(lcd), _valid(false), _cellsWritten(0), _presents(0), _glyphUploads(0) {
+    invalidate();
+}
+
+void LCDFrameBuffer::invalidate() {
+    // A display that needs rewriting may have lost its CGRAM too
+    _valid = false;
+    for (int slot = 0; slot < CGRAM_SLOTS; slot++) {
+        _slotGlyph[slot] = SLOT_FREE;
+        _slotUsed[slot] = 0;
+    }
+}
+
+uint32_t LCDFrameBuffer::glyphsIn(const LCDFrame& frame) {
+    uint32_t glyphs = 0;
+    for (int row = 0; row < LCD_LINES; row++) {
+        for (int col = 0; col < LCD_COLUMNS; col++) {
+            char c = frame.at(col, row);
+            if (LCDFrame::isGlyph(c)) {
+                glyphs |= 1u << (c - GLYPH_CODE_BASE);
+            }
+        }
+    }
+    return glyphs;
+}
+
+char LCDFrameBuffer::resolve(char c, uint32_t keep, uint32_t shown) {
+    if (!LCDFrame::isGlyph(c)) {
+        return c;
+    }
+    int glyph = c - GLYPH_CODE_BASE;
+    
+    // The glyph's own slot, else a free one, else the least recently used one
+    // that is off screen, else one whose cells this present() overwrites anyway
+    int best = -1;
+    int bestRank = 0;
+    for (int slot = 0; slot < CGRAM_SLOTS; slot++) {
+        int held = _slotGlyph[slot];
+        int rank;
+        if (held == glyph) {
+            best = slot;
+            break;
+        } else if (held == SLOT_FREE) {
+            rank = 3;
+        } else if (keep & (1u << held)) {
+            continue;
+        } else {
+            rank = (shown & (1u << held)) ? 1 : 2;
+        }
+        if (rank > bestRank || (rank == bestRank && _slotUsed[slot] < _slotUsed[best])) {
+            best = slot;
+            bestRank = rank;
+        }
+    }
+    if (best < 0) {
+        return ' ';  // More distinct glyphs on one frame than CGRAM holds
+    }
+    
+    if (_slotGlyph[best] != glyph) {
+        _lcd.defineGlyph(best, LCDFrame::glyphRows(static_cast<Glyph>(glyph)));
+        _slotGlyph[best] = static_cast<int8_t>(glyph);
+        _glyphUploads++;
+    }
+    _slotUsed[best] = _presents;
+    return static_cast<char>(best);
+}
+
+void LCDFrameBuffer::present(const LCDFrame& frame) {
+    char run[LCD_COLUMNS];
+    _presents++;
+    uint32_t errors = _lcd.writeErrors();
+    uint32_t keep = glyphsIn(frame);
+    uint32_t shown = _valid ? glyphsIn(_shadow) : 0;
+    
+    for (int row = 0; row < LCD_LINES; row++) {
+        int col = 0;
+        while (col < LCD_COLUMNS) {
+            if (_valid && frame.at(col, row) == _shadow.at(col, row)) {
+                col++;
+                continue;
+            }
+            
+            // Collect the run of changed cells - the display auto-increments,
+            // so the whole run costs one cursor move and one bus transaction
+            int start = col;
+            int length = 0;
+            while (col < LCD_COLUMNS && (!_valid || frame.at(col, row) != _shadow.at(col, row))) {
+                run[length++] = resolve(frame.at(col, row), keep, shown);
+                col++;
+            }
+            _lcd.write(start, row, run, length);
+            _cellsWritten += length;
+            
+            // The shadow keeps the frame's codes: a glyph compares equal
+            // whichever slot it was given
+            _shadow.locate(start, row);
+            for (int i = start; i < col; i++) {
+                _shadow.putc(frame.at(i, row));
+            }
+        }
+    }
+    _valid = true;
+    
+    // A lost burst leaves the display unlike the shadow - rewrite it all next time
+    if (_lcd.writeErrors() != errors) {
+        invalidate();
+    }
+}
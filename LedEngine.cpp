@@ -0,0 +1,149 @@
+/**
+ * @file LedEngine.cpp
+ * @brief Implementation of the LED pattern player
+ */
+
+#include "LedEngine.h"
+
+using namespace std::chrono;
+
+LedEngine::LedEngine(PinName pin)
+    : _pin(pin), _gpio(pin, 0),
+#if STATUS_LED_PWM
+      _pwm(pin), _carrier(false),
+#endif
+      _pattern(&LED_OFF), _step(0), _rampTick(0), _rampTicks(0), _brightness(255), _hardware(false),
+      _interrupts(0) {
+    outputSolid(false);
+}
+
+void LedEngine::showStatus(Status status) {
+    static const LedPattern* const patterns[] = {&LED_SOLID, &LED_BLINK, &LED_DOUBLE_BLINK, &LED_SOS};
+    play(*patterns[status]);
+}
+
+void LedEngine::setBrightness(uint8_t level) {
+    core_util_critical_section_enter();
+    _brightness = level;
+    core_util_critical_section_exit();
+    play(*_pattern);
+}
+
+void LedEngine::play(const LedPattern& pattern) {
+    // The step ISR must not see a half-switched pattern
+    core_util_critical_section_enter();
+    _timeout.detach();
+    _pattern = &pattern;
+    _step = 0;
+    _hardware = startInHardware();
+    if (!_hardware) {
+        enterStep();
+    }
+    core_util_critical_section_exit();
+}
+
+// ==================== STEPS ====================
+
+void LedEngine::enterStep() {
+    const LedStep& step = _pattern->steps[_step];
+    bool last = _step + 1 == _pattern->count;
+    
+    if (step.from == step.to) {
+        _rampTicks = 0;
+        output(step.from);
+        if (last && !_pattern->repeat) {
+            return;  // Holds for good - no timer needed
+        }
+        _timeout.attach(callback(this, &LedEngine::onTimeout), milliseconds(step.durationMs));
+        return;
+    }
+    
+    _rampTicks = step.durationMs / LED_RAMP_STEP_MS;
+    _rampTicks = _rampTicks ? _rampTicks : 1;
+    _rampTick = 0;
+    output(step.from);
+    _timeout.attach(callback(this, &LedEngine::onTimeout), milliseconds(step.durationMs / _rampTicks));
+}
+
+void LedEngine::onTimeout() {
+    _interrupts++;
+    const LedStep& step = _pattern->steps[_step];
+    
+    if (_rampTicks && ++_rampTick < _rampTicks) {
+        output(step.from + (step.to - step.from) * _rampTick / _rampTicks);
+        _timeout.attach(callback(this, &LedEngine::onTimeout), milliseconds(step.durationMs / _rampTicks));
+        return;
+    }
+    
+    if (_step + 1 < _pattern->count) {
+        _step++;
+    } else if (_pattern->repeat) {
+        _step = 0;
+    } else {
+        output(step.to);  // End of a one-shot ramp: hold its final level
+        return;
+    }
+    enterStep();
+}
+
+// ==================== OUTPUT ====================
+
+bool LedEngine::startInHardware() {
+#if STATUS_LED_PWM
+    const LedPattern& p = *_pattern;
+    if (p.count != 2 || !p.repeat || _brightness != 255) {
+        return false;
+    }
+    const LedStep& a = p.steps[0];
+    const LedStep& b = p.steps[1];
+    if (a.from != a.to || b.from != b.to || (a.from | b.from) != 255 || (a.from & b.from) != 0) {
+        return false;  // Not an on/off square wave
+    }
+    
+    // One timer period per blink, high for the 'on' step
+    _pwm.resume();
+    _carrier = false;
+    _pwm.period_ms(a.durationMs + b.durationMs);
+    _pwm.pulsewidth_ms(a.from ? a.durationMs : b.durationMs);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LedEngine::output(uint8_t level) {
+    uint32_t scaled = (level * _brightness + 127) / 255;
+#if STATUS_LED_PWM
+    if (scaled != 0 && scaled != 255) {
+        if (!_carrier) {
+            _pwm.resume();
+            _pwm.period_us(LED_PWM_PERIOD_US);
+            _carrier = true;
+        }
+        _pwm.write(scaled * scaled / 65025.0f);  // Perceived brightness is about duty squared
+        return;
+    }
+    outputSolid(scaled != 0);
+#else
+    outputSolid(scaled >= 128);
+#endif
+}
+
+void LedEngine::outputSolid(bool on) {
+#if STATUS_LED_PWM && defined(TARGET_STM)
+    _carrier = false;
+    _pwm.suspend();  // Stops the timer and drops the deep sleep lock
+    pin_function(_pin, STM_PIN_DATA(STM_MODE_OUTPUT_PP, GPIO_NOPULL, 0));  // Out of the timer alternate function
+    _gpio = on ? 1 : 0;
+#elif STATUS_LED_PWM
+    // No portable way back to GPIO mode - hold the level with the timer
+    if (!_carrier) {
+        _pwm.resume();
+        _pwm.period_us(LED_PWM_PERIOD_US);
+        _carrier = true;
+    }
+    _pwm.write(on ? 1.0f : 0.0f);
+#else
+    _gpio = on ? 1 : 0;
+#endif
+}
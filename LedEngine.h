@@ -0,0 +1,119 @@
+/**
+ * @file LedEngine.h
+ * @brief Plays LedPattern tables on the status LED
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * With STATUS_LED_PWM the LED pin must be a timer channel (PwmOut):
+ * - A plain blink at full brightness runs as a slow PWM whose period is the
+ *   blink period. The timer toggles the pin itself, so the CPU takes no
+ *   interrupts until the next pattern change.
+ * - Other patterns step through their table from a LowPowerTimeout: one
+ *   interrupt per step, or per LED_RAMP_STEP_MS while ramping. Dimmed levels
+ *   use a LED_PWM_PERIOD_US carrier with a squared (perceptual) duty.
+ * - Solid off/full levels release the timer and drive the pin as a GPIO, so
+ *   an idle door does not hold the deep sleep lock. A running PWM (blink, dim)
+ *   does.
+ * Without STATUS_LED_PWM the steps drive a GPIO: brightness above half is on.
+ *
+ * play(), showStatus() and setBrightness() switch patterns atomically and may
+ * be called from any thread.
+ */
+
+#ifndef LED_ENGINE_H
+#define LED_ENGINE_H
+
+#include "mbed.h"
+#include "LedPattern.h"
+#include "DoorIO.h"    // StatusIndicator
+#include "config.h"
+
+/**
+ * @class LedEngine
+ * @brief Status LED driven by pattern tables
+ */
+class LedEngine : public StatusIndicator {
+public:
+    /**
+     * @brief Constructor - the LED starts off
+     * @param pin LED pin (a timer channel if STATUS_LED_PWM)
+     */
+    explicit LedEngine(PinName pin);
+    
+    /**
+     * @brief Start a pattern from its first step, replacing the current one
+     */
+    void play(const LedPattern& pattern);
+    
+    /**
+     * @brief Play the pattern of a door status (LedPattern.h)
+     */
+    void showStatus(Status status) override;
+    
+    /**
+     * @brief Scale every level; restarts the current pattern
+     */
+    void setBrightness(uint8_t level) override;
+    
+    uint8_t brightness() const {
+        return _brightness;
+    }
+    
+    /**
+     * @brief Check whether the current pattern runs on the timer alone
+     */
+    bool inHardware() const {
+        return _hardware;
+    }
+    
+    /**
+     * @brief Step interrupts taken since boot
+     */
+    uint32_t stepInterrupts() const {
+        return _interrupts;
+    }
+    
+private:
+    PinName _pin;
+    DigitalOut _gpio;                   // Solid levels (and every level without PWM)
+#if STATUS_LED_PWM
+    PwmOut _pwm;
+    bool _carrier;                      // _pwm running the dimming carrier
+#endif
+    LowPowerTimeout _timeout;           // Next step or ramp update
+    const LedPattern* _pattern;
+    uint8_t _step;                      // Index into _pattern->steps
+    uint16_t _rampTick;                 // Ramp updates done in this step
+    uint16_t _rampTicks;                // Ramp updates in this step, 0 = constant
+    uint8_t _brightness;
+    bool _hardware;                     // Pattern runs as a slow PWM
+    volatile uint32_t _interrupts;
+    
+    /**
+     * @brief Output the current step and arm the timeout for what follows
+     */
+    void enterStep();
+    
+    /**
+     * @brief Timeout ISR - next ramp level or next step
+     */
+    void onTimeout();
+    
+    /**
+     * @brief Try to run the pattern as a slow PWM (blink at full brightness)
+     * @return true if the timer now plays it
+     */
+    bool startInHardware();
+    
+    /**
+     * @brief Drive one pattern level, scaled by the brightness
+     */
+    void output(uint8_t level);
+    
+    /**
+     * @brief Release the PWM and drive the pin as a GPIO
+     */
+    void outputSolid(bool on);
+};
+
+#endif // LED_ENGINE_H
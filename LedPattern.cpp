@@ -0,0 +1,46 @@
+/**
+ * @file LedPattern.cpp
+ * @brief The LED pattern tables
+ */
+
+#include "LedPattern.h"
+#include "config.h"
+
+#define LED_PATTERN(name, repeat, ...)                                          \
+    static const LedStep name##_STEPS[] = {__VA_ARGS__};                        \
+    const LedPattern name = {name##_STEPS, sizeof(name##_STEPS) / sizeof(LedStep), repeat}
+
+// ==================== STATUS ====================
+
+LED_PATTERN(LED_SOLID, false, {1, 255, 255});
+
+LED_PATTERN(LED_BLINK, true,
+    {LED_FLASH_PERIOD_MS / 2, 255, 255},
+    {LED_FLASH_PERIOD_MS / 2, 0, 0});
+
+LED_PATTERN(LED_DOUBLE_BLINK, true,
+    {100, 255, 255}, {100, 0, 0},
+    {100, 255, 255}, {700, 0, 0});
+
+// Dot 150ms, dash 450ms, gaps of one dot, three dots between letters
+LED_PATTERN(LED_SOS, true,
+    {150, 255, 255}, {150, 0, 0}, {150, 255, 255}, {150, 0, 0}, {150, 255, 255}, {450, 0, 0},
+    {450, 255, 255}, {150, 0, 0}, {450, 255, 255}, {150, 0, 0}, {450, 255, 255}, {450, 0, 0},
+    {150, 255, 255}, {150, 0, 0}, {150, 255, 255}, {150, 0, 0}, {150, 255, 255}, {1050, 0, 0});
+
+// ==================== OTHERS ====================
+
+LED_PATTERN(LED_OFF, false, {1, 0, 0});
+
+LED_PATTERN(LED_FAST_BLINK, true,
+    {100, 255, 255},
+    {100, 0, 0});
+
+LED_PATTERN(LED_HEARTBEAT, true,
+    {60, 0, 255}, {120, 255, 0},
+    {60, 0, 255}, {240, 255, 0},
+    {520, 0, 0});
+
+LED_PATTERN(LED_BREATHE, true,
+    {1500, 0, 255},
+    {1500, 255, 0});
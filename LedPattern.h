@@ -0,0 +1,49 @@
+/**
+ * @file LedPattern.h
+ * @brief Declarative LED patterns: tables of timed brightness steps
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * A pattern is a list of steps, each holding or ramping the brightness for a
+ * while; LedEngine plays it on the status LED. Blinks are two constant steps,
+ * fades are ramps, anything longer (SOS) is just more steps. The tables are
+ * plain constant data, so they live in flash and need no Mbed.
+ */
+
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include <cstdint>
+
+/**
+ * @brief One step: brightness goes from 'from' to 'to' over durationMs
+ * from == to holds a constant level.
+ */
+struct LedStep {
+    uint16_t durationMs;
+    uint8_t from;       // 0 = off, 255 = full
+    uint8_t to;
+};
+
+/**
+ * @brief A sequence of steps, played once or in a loop
+ */
+struct LedPattern {
+    const LedStep* steps;
+    uint8_t count;
+    bool repeat;        // Loop forever, else hold the last level
+};
+
+// Status patterns (StatusIndicator::Status)
+extern const LedPattern LED_SOLID;          // Closed: on
+extern const LedPattern LED_BLINK;          // Open: LED_FLASH_PERIOD_MS square wave
+extern const LedPattern LED_DOUBLE_BLINK;   // Lockout: two short flashes per second
+extern const LedPattern LED_SOS;            // Fault: ... --- ...
+
+// Other patterns
+extern const LedPattern LED_OFF;
+extern const LedPattern LED_FAST_BLINK;     // 5Hz square wave
+extern const LedPattern LED_HEARTBEAT;      // Two beats, then a pause
+extern const LedPattern LED_BREATHE;        // Slow fade in and out
+
+#endif // LED_PATTERN_H
@@ -0,0 +1,153 @@
+/**
+ * @file LockDriver.cpp
+ * @brief Implementation of the relay/servo lock driver
+ */
+
+#include "LockDriver.h"
+
+using namespace std::chrono;
+
+#if RELAY_STAGGER_PULL_IN
+// End of the latest pull-in pulse reserved by any relay (changed in critical sections)
+static Kernel::Clock::time_point pullInFreeAt;
+#endif
+
+LockDriver::LockDriver(PinName pin, Mode mode)
+    : _pin(pin), _mode(mode), _gpio(pin, 0), _pwm(pin), _open(false), _actuating(false),
+      _fromUs(SERVO_CLOSED_US), _toUs(SERVO_CLOSED_US), _positionUs(SERVO_CLOSED_US), _frame(0), _frames(0),
+      _lastActuationUs(0), _actuations(0), _pullInPending(false) {
+    outputSolid(false);
+}
+
+void LockDriver::setOpen(bool open) {
+    // The motion ISR must not see a half-started command
+    core_util_critical_section_enter();
+    _timeout.detach();
+    releasePullIn();
+    _open = open;
+    _actuating = true;
+    _clock.reset();
+    _clock.start();
+
+    if (_mode == MODE_RELAY && !open) {
+        outputSolid(false);
+        complete();
+    } else if (_mode == MODE_RELAY) {
+#if RELAY_STAGGER_PULL_IN
+        Kernel::Clock::time_point now = Kernel::Clock::now();
+        Kernel::Clock::time_point start = pullInFreeAt > now ? pullInFreeAt : now;
+        pullInFreeAt = start + milliseconds(RELAY_PULL_IN_MS);
+        if (start > now) {
+            _pullInSlot = start;
+            _pullInPending = true;
+            _timeout.attach(callback(this, &LockDriver::startPullIn), start - now);
+        } else {
+            startPullIn();
+        }
+#else
+        startPullIn();
+#endif
+    } else {
+        // Frames in proportion to the distance, so a full move always takes SERVO_TRAVEL_MS
+        _fromUs = _positionUs;
+        _toUs = open ? SERVO_OPEN_US : SERVO_CLOSED_US;
+        uint32_t distance = _toUs > _fromUs ? _toUs - _fromUs : _fromUs - _toUs;
+        _frames = (SERVO_TRAVEL_MS / SERVO_FRAME_MS) * distance / (SERVO_OPEN_US - SERVO_CLOSED_US);
+        _frames = _frames ? _frames : 1;
+        _frame = 0;
+        _pwm.resume();
+        _pwm.period_ms(SERVO_FRAME_MS);
+        _pwm.pulsewidth_us(_positionUs);
+        _timeout.attach(callback(this, &LockDriver::servoFrame), milliseconds(SERVO_FRAME_MS));
+    }
+    core_util_critical_section_exit();
+}
+
+void LockDriver::setMode(Mode mode) {
+    core_util_critical_section_enter();
+    _timeout.detach();
+    releasePullIn();
+    _mode = mode;
+    _positionUs = SERVO_CLOSED_US;  // Assumed until the first move
+    outputSolid(false);
+    core_util_critical_section_exit();
+}
+
+// ==================== RELAY ====================
+
+void LockDriver::startPullIn() {
+    _pullInPending = false;
+    outputSolid(true);
+    _timeout.attach(callback(this, &LockDriver::startHold), milliseconds(RELAY_PULL_IN_MS));
+}
+
+void LockDriver::releasePullIn() {
+#if RELAY_STAGGER_PULL_IN
+    if (!_pullInPending) {
+        return;
+    }
+    _pullInPending = false;
+    // The last slot is simply given back. An earlier one stays a gap: the
+    // doors queued behind it already have their start times
+    if (pullInFreeAt == _pullInSlot + milliseconds(RELAY_PULL_IN_MS)) {
+        pullInFreeAt = _pullInSlot;
+    }
+#endif
+}
+
+void LockDriver::startHold() {
+#if RELAY_HOLD_PERCENT < 100
+    _pwm.resume();
+    _pwm.period_us(RELAY_PWM_PERIOD_US);
+    _pwm.write(RELAY_HOLD_PERCENT / 100.0f);
+#endif
+    complete();
+}
+
+// ==================== SERVO ====================
+
+void LockDriver::servoFrame() {
+    _frame++;
+
+    // Smoothstep easing, 3t^2 - 2t^3 in 16.16 fixed point: zero speed at both ends
+    uint64_t t = (uint64_t)_frame * 65536 / _frames;
+    uint32_t eased = (uint32_t)((t * t * (3 * 65536 - 2 * t)) >> 32);
+    int32_t span = (int32_t)_toUs - (int32_t)_fromUs;
+    _positionUs = (uint16_t)(_fromUs + span * (int32_t)eased / 65536);
+    _pwm.pulsewidth_us(_positionUs);
+
+    if (_frame < _frames) {
+        _timeout.attach(callback(this, &LockDriver::servoFrame), milliseconds(SERVO_FRAME_MS));
+        return;
+    }
+    complete();
+    _timeout.attach(callback(this, &LockDriver::servoRelease), milliseconds(SERVO_SETTLE_MS));
+}
+
+void LockDriver::servoRelease() {
+    outputSolid(false);
+}
+
+// ==================== OUTPUT ====================
+
+void LockDriver::complete() {
+    _clock.stop();
+    _lastActuationUs = duration_cast<microseconds>(_clock.elapsed_time()).count();
+    _actuations++;
+    _actuating = false;
+    if (_onComplete) {
+        _onComplete();
+    }
+}
+
+void LockDriver::outputSolid(bool on) {
+#if defined(TARGET_STM)
+    _pwm.suspend();  // Stops the timer and drops the deep sleep lock
+    pin_function(_pin, STM_PIN_DATA(STM_MODE_OUTPUT_PP, GPIO_NOPULL, 0));  // Out of the timer alternate function
+    _gpio = on ? 1 : 0;
+#else
+    // No portable way back to GPIO mode - hold the level with the timer
+    _pwm.resume();
+    _pwm.write(on ? 1.0f : 0.0f);
+#endif
+}
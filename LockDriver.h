@@ -0,0 +1,154 @@
+/**
+ * @file LockDriver.h
+ * @brief Lock actuator driver: relay pull-in/hold or a profiled servo move
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Relay: opening drives the coil fully for RELAY_PULL_IN_MS, then holds it
+ * with a RELAY_HOLD_PERCENT PWM (a pulled-in armature needs a fraction of
+ * the pull-in current). Closing releases the PWM and drives the pin low as a
+ * GPIO. With RELAY_STAGGER_PULL_IN, drivers that open at the same time pull in
+ * one after another, so the supply only ever sees one pull-in current.
+ *
+ * Servo: the pulse moves from SERVO_CLOSED_US to SERVO_OPEN_US (or back) in
+ * 20 ms frames along an eased profile over SERVO_TRAVEL_MS, so the motor
+ * never sees a step. The PWM is suspended SERVO_SETTLE_MS after the motion
+ * ends. A new command during a move starts from the current position.
+ *
+ * The motion runs from a LowPowerTimeout, so setOpen() returns at once. The
+ * completion handler runs in interrupt context when the lock is in position
+ * (relay pulled in or released, servo at its target); the time from the
+ * command to that point is kept for measurement.
+ */
+
+#ifndef LOCK_DRIVER_H
+#define LOCK_DRIVER_H
+
+#include "mbed.h"
+#include "DoorIO.h"    // LockActuator
+#include "config.h"
+
+/**
+ * @class LockDriver
+ * @brief Relay or servo lock output with timed actuation
+ */
+class LockDriver : public LockActuator {
+public:
+    enum Mode : uint8_t {
+        MODE_RELAY,
+        MODE_SERVO
+    };
+
+    /**
+     * @brief Constructor - the relay is released / the servo is not driven until setOpen()
+     * @param pin Lock output (a timer channel in both modes)
+     * @param mode Relay coil or servo signal
+     */
+    LockDriver(PinName pin, Mode mode);
+
+    /**
+     * @brief Start moving the lock; returns without waiting for the motion
+     */
+    void setOpen(bool open) override;
+
+    /**
+     * @brief Switch between relay and servo (the stored setting, read after the boot)
+     * Releases the output; call setOpen(false) afterwards to drive the new mode closed.
+     */
+    void setMode(Mode mode);
+
+    /**
+     * @brief Called (ISR context) each time an actuation completes
+     */
+    void setCompleteHandler(Callback<void()> handler) {
+        _onComplete = handler;
+    }
+
+    Mode mode() const {
+        return _mode;
+    }
+
+    bool isOpen() const {
+        return _open;
+    }
+
+    /**
+     * @brief Check whether the last command is still in motion
+     */
+    bool actuating() const {
+        return _actuating;
+    }
+
+    /**
+     * @brief Time from the last completed command to the lock being in position
+     */
+    uint32_t lastActuationUs() const {
+        return _lastActuationUs;
+    }
+
+    /**
+     * @brief Actuations completed since boot
+     */
+    uint32_t actuations() const {
+        return _actuations;
+    }
+
+private:
+    static const int SERVO_FRAME_MS = 20;   // 50 Hz servo signal, one profile point per frame
+
+    PinName _pin;
+    Mode _mode;
+    DigitalOut _gpio;                   // Relay released / held without PWM
+    PwmOut _pwm;
+    LowPowerTimeout _timeout;           // Next phase or profile frame
+    LowPowerTimer _clock;               // Command to completion
+    Callback<void()> _onComplete;
+    bool _open;
+    volatile bool _actuating;
+    uint16_t _fromUs;                   // Servo move start pulse
+    uint16_t _toUs;                     // Servo move target pulse
+    uint16_t _positionUs;               // Servo pulse being output
+    uint16_t _frame;                    // Servo frames done in this move
+    uint16_t _frames;                   // Servo frames in this move
+    volatile uint32_t _lastActuationUs;
+    volatile uint32_t _actuations;
+    Kernel::Clock::time_point _pullInSlot;  // Start of the reserved pull-in slot
+    volatile bool _pullInPending;       // Slot reserved, pull-in not started yet
+
+    /**
+     * @brief Relay: drive the coil fully (after any stagger delay)
+     */
+    void startPullIn();
+
+    /**
+     * @brief Hand back a pull-in slot whose open was cancelled before it started
+     */
+    void releasePullIn();
+
+    /**
+     * @brief Relay: pull-in done, drop to the hold duty
+     */
+    void startHold();
+
+    /**
+     * @brief Servo: output the next profile point
+     */
+    void servoFrame();
+
+    /**
+     * @brief Servo: stop the pulses once it has settled (PwmOut blocks deep sleep)
+     */
+    void servoRelease();
+
+    /**
+     * @brief Record the actuation time and notify
+     */
+    void complete();
+
+    /**
+     * @brief Release the PWM and drive the pin as a GPIO
+     */
+    void outputSolid(bool on);
+};
+
+#endif // LOCK_DRIVER_H
@@ -0,0 +1,383 @@
+/**
+ * @file MaintenanceConsole.cpp
+ * @brief Implementation of the PIN store console
+ */
+
+#include "MaintenanceConsole.h"
+#include "Secure.h"
+#include "Profiler.h"
+
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+MaintenanceConsole::MaintenanceConsole(PinStore& store, AuditLog& audit, PinName tx, PinName rx,
+                                       int baud)
+    : _store(store), _audit(audit), _bootTimes(nullptr), _lock(nullptr), _deadlines(nullptr), _config(nullptr), _serial(tx, rx, baud), _thread(osPriorityLow, 2048, nullptr, "console"),
+      _loggedIn(false), _failedLogins(0) {
+}
+
+void MaintenanceConsole::start() {
+    _thread.start(callback(this, &MaintenanceConsole::run));
+}
+
+void MaintenanceConsole::print(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    tinyVWrite(_serial, format, args);
+    va_end(args);
+}
+
+void MaintenanceConsole::printUser(uint16_t userId) {
+    print("  %u\r\n", userId);
+}
+
+void MaintenanceConsole::printLine(const char* text) {
+    print("%s\r\n", text);
+}
+
+void MaintenanceConsole::printProfile() {
+#if ENABLE_PROFILING
+    print("--- profile ---\r\n");
+    Profiler::report(callback(this, &MaintenanceConsole::printLine));
+#else
+    print("Profiling disabled (ENABLE_PROFILING)\r\n");
+#endif
+}
+
+void MaintenanceConsole::printLog(int count) {
+    static const char* const names[] = {
+        "?", "boot", "granted", "denied", "lockout", "lockout end", "key", "pin set", "pin del",
+        "watchdog reset", "config", "console denied", "clock set"
+    };
+    
+    for (int age = count - 1; age >= 0; age--) {
+        AuditLog::Entry entry;
+        if (!_audit.readRecent(age, entry)) {
+            continue;  // Fewer entries than asked for
+        }
+        const char* name = entry.event < sizeof(names) / sizeof(names[0]) ? names[entry.event] : "?";
+        // Times from an RTC that was never set count from its power-up
+        print("#%lu t=%s%lu %s", (unsigned long)entry.sequence, entry.time < AUDIT_CLOCK_MIN_EPOCH ? "+" : "",
+              (unsigned long)entry.time, name);
+        if (entry.userId != AuditLog::NO_USER) {
+            print(" user=%u", entry.userId);
+        }
+        if (entry.event == AuditLog::EVENT_SPECIAL_KEY) {
+            print(" key=%c", entry.arg);
+        } else if (entry.arg) {
+            print(" arg=%u", entry.arg);
+        }
+        print("\r\n");
+    }
+    if (_audit.dropped()) {
+        print("(%lu entries dropped)\r\n", (unsigned long)_audit.dropped());
+    }
+}
+
+void MaintenanceConsole::printBootTimes() {
+    if (!_bootTimes) {
+        print("No boot times recorded\r\n");
+        return;
+    }
+    print("lock %lu ms, keypad %lu ms, stores %lu ms, ready %lu ms\r\n",
+          (unsigned long)_bootTimes->lockMs, (unsigned long)_bootTimes->keypadMs,
+          (unsigned long)_bootTimes->storeMs, (unsigned long)_bootTimes->readyMs);
+    uint32_t displayMs = _bootTimes->displayMs;
+    if (displayMs) {
+        print("display %lu ms\r\n", (unsigned long)displayMs);
+    } else {
+        print("display not initialised\r\n");
+    }
+}
+
+void MaintenanceConsole::printLock() {
+    if (!_lock) {
+        print("No lock driver\r\n");
+        return;
+    }
+    print("%s, %s%s, last actuation %lu us, %lu actuations\r\n",
+          _lock->mode() == LockDriver::MODE_RELAY ? "relay" : "servo", _lock->isOpen() ? "open" : "closed",
+          _lock->actuating() ? " (moving)" : "", (unsigned long)_lock->lastActuationUs(),
+          (unsigned long)_lock->actuations());
+}
+
+void MaintenanceConsole::printDeadlines() {
+    if (!_deadlines) {
+        print("No deadline tracking\r\n");
+        return;
+    }
+    // Counters belong to the event thread; a figure may be one run behind
+    for (int i = 0; i < _deadlines->taskCount(); i++) {
+        const DeadlineScheduler::TaskStats& task = _deadlines->task(i);
+        print("%-8s period %5lu ms, deadline %4lu ms: %lu runs, %lu overruns, worst %lu ms late\r\n",
+              task.name, (unsigned long)task.periodMs, (unsigned long)task.deadlineMs,
+              (unsigned long)task.runs, (unsigned long)task.overruns, (unsigned long)task.worstLateMs);
+    }
+    print("%lu untracked timers, %lu / %lu checks failed\r\n", (unsigned long)_deadlines->untracked(),
+          (unsigned long)_deadlines->failedCheckpoints(), (unsigned long)_deadlines->checkpoints());
+}
+
+void MaintenanceConsole::printConfig() {
+    static const char* const sources[] = {"no store, defaults", "defaults", "stored", "stored record rejected, defaults"};
+    if (!_config) {
+        print("No runtime config\r\n");
+        return;
+    }
+    for (int i = 0; i < DoorSettings::fieldCount(); i++) {
+        const DoorSettings::Field& field = DoorSettings::field(i);
+        print("%-11s %7lu  (%lu..%lu, default %lu)%s\r\n", field.name, (unsigned long)_config->settings().get(i),
+              (unsigned long)field.min, (unsigned long)field.max, (unsigned long)DoorSettings::defaults().get(i),
+              field.atBoot ? " at boot" : "");
+    }
+    print("Source: %s\r\n", sources[_config->source()]);
+}
+
+void MaintenanceConsole::changeConfig(const char* name, const char* value) {
+    static const char* const results[] = {"OK", "Unknown setting", "Out of range", "Applied, not saved"};
+    if (!_config) {
+        print("No runtime config\r\n");
+        return;
+    }
+    RuntimeConfig::Result result;
+    if (strcmp(name, "defaults") == 0) {
+        result = _config->restoreDefaults();
+        _audit.record(AuditLog::EVENT_CONFIG_CHANGED, 0xFF);
+    } else {
+        char* end = nullptr;
+        unsigned long number = value ? strtoul(value, &end, 10) : 0;
+        if (!value || *end != '\0') {
+            print("Usage: config <name> <value> | config defaults\r\n");
+            return;
+        }
+        result = _config->set(name, number);
+        if (result == RuntimeConfig::RESULT_OK || result == RuntimeConfig::RESULT_NOT_SAVED) {
+            _audit.record(AuditLog::EVENT_CONFIG_CHANGED, (uint8_t)DoorSettings::find(name));
+        }
+    }
+    print("%s\r\n", results[result]);
+}
+
+void MaintenanceConsole::changeTime(const char* epoch) {
+    char* end = nullptr;
+    unsigned long seconds = epoch ? strtoul(epoch, &end, 10) : 0;
+    if (!epoch || *epoch < '0' || *epoch > '9' || *end != '\0' || seconds < AUDIT_CLOCK_MIN_EPOCH) {
+        print("Usage: time <unix seconds, %lu or later>\r\n", (unsigned long)AUDIT_CLOCK_MIN_EPOCH);
+        return;
+    }
+    // The pair of entries maps the old clock onto the new one
+    _audit.record(AuditLog::EVENT_CLOCK_SET, 0);
+    set_time(static_cast<time_t>(seconds));
+    _audit.record(AuditLog::EVENT_CLOCK_SET, 1);
+    print("OK\r\n");
+}
+
+bool MaintenanceConsole::isValidPin(const char* pin) {
+    size_t length = strlen(pin);
+    if (length == 0 || length > MAX_PASSWORD_LENGTH) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (pin[i] < '0' || pin[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MaintenanceConsole::parseUserId(const char* text, uint16_t& userId) {
+    if (!text || *text < '0' || *text > '9') {
+        return false;  // strtoul would also take signs and spaces
+    }
+    char* end = nullptr;
+    unsigned long number = strtoul(text, &end, 10);
+    if (*end != '\0' || number >= AuditSink::NO_USER) {
+        return false;
+    }
+    userId = static_cast<uint16_t>(number);
+    return true;
+}
+
+void MaintenanceConsole::login(const char* pin) {
+    const DoorSettings& settings = _config ? _config->settings() : DoorSettings::defaults();
+    Kernel::Clock::time_point now = Kernel::Clock::now();
+    if (_failedLogins >= settings.maxFailedAttempts) {
+        if (now < _lockedUntil) {
+            auto left = std::chrono::duration_cast<std::chrono::seconds>(_lockedUntil - now);
+            print("Locked out, %lu s left\r\n", (unsigned long)left.count() + 1);
+            return;
+        }
+        _failedLogins = 0;
+    }
+    
+    uint16_t userId;
+    _loggedIn = pin && isValidPin(pin) && _store.verify(pin, strlen(pin), &userId) &&
+                userId == ADMIN_USER_ID;
+    if (_loggedIn) {
+        _failedLogins = 0;
+        _lastCommand = now;
+        print("OK\r\n");
+        return;
+    }
+    
+    _failedLogins++;
+    _audit.record(AuditLog::EVENT_CONSOLE_DENIED, _failedLogins);
+    if (_failedLogins >= settings.maxFailedAttempts) {
+        _lockedUntil = now + std::chrono::milliseconds(settings.lockoutTimeMs);
+        _audit.record(AuditLog::EVENT_LOCKOUT, 1);
+        print("Denied, locked out for %lu s\r\n", (unsigned long)(settings.lockoutTimeMs / 1000));
+    } else {
+        print("Denied\r\n");
+    }
+}
+
+void MaintenanceConsole::run() {
+    print("\r\nDoor Lock maintenance console - 'help' for commands\r\n> ");
+    
+    int length = 0;
+    while (true) {
+        char c;
+        if (_serial.read(&c, 1) != 1) {
+            continue;
+        }
+        
+        if (c == '\r' || c == '\n') {
+            print("\r\n");
+            _line[length] = '\0';
+            if (length > 0) {
+                execute(_line);
+            }
+            secureWipe(_line, sizeof(_line));  // May have held a PIN
+            length = 0;
+            print("> ");
+        } else if ((c == '\b' || c == 0x7F) && length > 0) {
+            length--;
+            print("\b \b");
+        } else if (c >= ' ' && length < LINE_SIZE - 1) {
+            _line[length++] = c;
+            _serial.write(&c, 1);
+        }
+    }
+}
+
+void MaintenanceConsole::execute(char* line) {
+    char* save = nullptr;
+    char* command = strtok_r(line, " ", &save);
+    char* arg1 = strtok_r(nullptr, " ", &save);
+    char* arg2 = strtok_r(nullptr, " ", &save);
+    if (!command) {
+        return;
+    }
+    
+    if (_loggedIn && Kernel::Clock::now() - _lastCommand > std::chrono::milliseconds(CONSOLE_SESSION_TIMEOUT_MS)) {
+        _loggedIn = false;
+        print("Session timed out\r\n");
+    }
+    
+    if (strcmp(command, "help") == 0) {
+        print("login <pin> | set <user> <pin> | del <user> | list | count | info | log [n] | prof [reset] | boot | lock | deadlines | config [<name> <value>|defaults] | time [epoch] | logout\r\n");
+        return;
+    }
+    
+    // Timing figures are not sensitive - no session needed
+    if (strcmp(command, "prof") == 0) {
+#if ENABLE_PROFILING
+        if (arg1 && strcmp(arg1, "reset") == 0) {
+            Profiler::reset();
+            print("OK\r\n");
+            return;
+        }
+#endif
+        printProfile();
+        return;
+    }
+    if (strcmp(command, "boot") == 0) {
+        printBootTimes();
+        return;
+    }
+    if (strcmp(command, "lock") == 0) {
+        printLock();
+        return;
+    }
+    if (strcmp(command, "deadlines") == 0) {
+        printDeadlines();
+        return;
+    }
+    if (strcmp(command, "config") == 0 && !arg1) {
+        printConfig();
+        return;
+    }
+    if (strcmp(command, "time") == 0 && !arg1) {
+        unsigned long now = static_cast<unsigned long>(time(nullptr));
+        print("%lu%s\r\n", now, now < AUDIT_CLOCK_MIN_EPOCH ? " (not set)" : "");
+        return;
+    }
+    
+    if (strcmp(command, "login") == 0) {
+        login(arg1);
+        return;
+    }
+    
+    if (!_loggedIn) {
+        print("Login first\r\n");
+        return;
+    }
+    _lastCommand = Kernel::Clock::now();
+    
+    if (strcmp(command, "logout") == 0) {
+        _loggedIn = false;
+        print("OK\r\n");
+    } else if (strcmp(command, "count") == 0) {
+        print("%u / %u users\r\n", (unsigned)_store.count(), (unsigned)PinStore::capacity());
+    } else if (strcmp(command, "info") == 0) {
+        print("KDF %lu rounds, last hash %lu us, SHA-256 in %s\r\n",
+              (unsigned long)_store.kdfIterations(), (unsigned long)_store.lastHashUs(),
+              PinStore::hardwareHash() ? "hardware" : "software");
+    } else if (strcmp(command, "log") == 0) {
+        unsigned long count = 10;
+        if (arg1) {
+            char* end = nullptr;
+            count = strtoul(arg1, &end, 10);
+            if (*arg1 < '0' || *arg1 > '9' || *end != '\0') {
+                print("Usage: log [n]\r\n");
+                return;
+            }
+        }
+        // More than the log holds would only walk the sectors again for nothing
+        printLog(static_cast<int>(count < _audit.capacity() ? count : _audit.capacity()));
+    } else if (strcmp(command, "list") == 0) {
+        _store.forEachUser(callback(this, &MaintenanceConsole::printUser));
+    } else if (strcmp(command, "set") == 0 && arg1 && arg2 && isValidPin(arg2)) {
+        static const char* const results[] = {"OK", "Not found", "PIN in use", "Store full", "Flash error"};
+        uint16_t userId;
+        if (!parseUserId(arg1, userId)) {
+            print("Bad user ID (0..%u)\r\n", (unsigned)AuditSink::NO_USER - 1);
+            return;
+        }
+        PinStore::Status status = _store.setPin(userId, arg2, strlen(arg2));
+        if (status == PinStore::OK) {
+            _audit.record(AuditLog::EVENT_PIN_CHANGED, 0, userId);
+        }
+        print("%s\r\n", results[status]);
+    } else if (strcmp(command, "del") == 0 && arg1) {
+        uint16_t userId;
+        if (!parseUserId(arg1, userId)) {
+            print("Bad user ID (0..%u)\r\n", (unsigned)AuditSink::NO_USER - 1);
+        } else if (userId == ADMIN_USER_ID) {
+            print("Cannot delete the admin\r\n");
+        } else {
+            bool removed = _store.remove(userId) == PinStore::OK;
+            if (removed) {
+                _audit.record(AuditLog::EVENT_PIN_DELETED, 0, userId);
+            }
+            print(removed ? "OK\r\n" : "Not found\r\n");
+        }
+    } else if (strcmp(command, "config") == 0) {
+        changeConfig(arg1, arg2);
+    } else if (strcmp(command, "time") == 0) {
+        changeTime(arg1);
+    } else {
+        print("Bad command - 'help' for usage\r\n");
+    }
+}
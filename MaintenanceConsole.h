@@ -0,0 +1,139 @@
+/**
+ * @file MaintenanceConsole.h
+ * @brief Serial command line for managing the PIN store
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * Runs in its own low-priority thread on the USB serial port. Every command
+ * except help, login and the read-only figures needs an admin session, opened with the ADMIN_USER_ID PIN.
+ * Wrong logins are audited and lock the console out like the keypad (same
+ * attempts and lockout settings); a session idle for CONSOLE_SESSION_TIMEOUT_MS
+ * is closed before the next command runs:
+ * 
+ *   login <pin>          open an admin session
+ *   set <user> <pin>     add a user or change their PIN
+ *   del <user>           delete a user
+ *   list                 list stored user IDs
+ *   count                users stored / capacity
+ *   info                 PIN hash rounds and time
+ *   log [n]              last n audit log entries (default 10)
+ *   prof [reset]         profiler report (ENABLE_PROFILING builds), or clear it
+ *   boot                 time from reset to each boot stage
+ *   lock                 lock driver mode, position and last actuation time
+ *   deadlines            per-task runs, overruns and worst lateness
+ *   config               door settings in use, their ranges and defaults
+ *   config <name> <v>    change a door setting (saved in flash, applied live)
+ *   config defaults      back to the config.h values
+ *   time [epoch]         show the RTC, or set it (Unix seconds, audited)
+ *   logout               close the session
+ */
+
+#ifndef MAINTENANCE_CONSOLE_H
+#define MAINTENANCE_CONSOLE_H
+
+#include "mbed.h"
+#include "PinStore.h"
+#include "AuditLog.h"
+#include "BootTimes.h"
+#include "LockDriver.h"
+#include "DeadlineScheduler.h"
+#include "RuntimeConfig.h"
+#include "TinyFormat.h"
+
+/**
+ * @class MaintenanceConsole
+ * @brief Line-based admin console for PinStore
+ */
+class MaintenanceConsole {
+public:
+    /**
+     * @brief Constructor
+     * @param store Credential store to manage
+     * @param audit Log that records PIN changes and is shown by 'log'
+     * @param tx Serial TX pin
+     * @param rx Serial RX pin
+     * @param baud Baud rate
+     */
+    MaintenanceConsole(PinStore& store, AuditLog& audit, PinName tx, PinName rx, int baud = 9600);
+    
+    /**
+     * @brief Boot milestones shown by 'boot' (kept by the caller)
+     */
+    void setBootTimes(const BootTimes* times) {
+        _bootTimes = times;
+    }
+    
+    /**
+     * @brief Lock driver shown by 'lock'
+     */
+    void setLock(const LockDriver* lock) {
+        _lock = lock;
+    }
+    
+    /**
+     * @brief Task deadlines shown by 'deadlines'
+     */
+    void setDeadlines(const DeadlineScheduler* deadlines) {
+        _deadlines = deadlines;
+    }
+    
+    /**
+     * @brief Door settings shown and changed by 'config'
+     */
+    void setConfig(RuntimeConfig* config) {
+        _config = config;
+    }
+    
+    /**
+     * @brief Start the console thread
+     */
+    void start();
+    
+    /**
+     * @brief Print the profiler report (any thread)
+     */
+    void printProfile();
+    
+private:
+    static const int LINE_SIZE = 48;
+    
+    PinStore& _store;
+    AuditLog& _audit;
+    const BootTimes* _bootTimes;
+    const LockDriver* _lock;
+    const DeadlineScheduler* _deadlines;
+    RuntimeConfig* _config;
+    BufferedSerial _serial;
+    Thread _thread;
+    bool _loggedIn;
+    uint8_t _failedLogins;
+    Kernel::Clock::time_point _lockedUntil;     // Console login lockout end
+    Kernel::Clock::time_point _lastCommand;     // Session idle timeout start
+    char _line[LINE_SIZE];
+    
+    void run();
+    void execute(char* line);
+    void print(const char* format, ...) TINY_FORMAT_CHECK(2, 3);
+    void printUser(uint16_t userId);
+    void printLog(int count);
+    void printBootTimes();
+    void printLock();
+    void printDeadlines();
+    void printConfig();
+    void changeConfig(const char* name, const char* value);
+    void login(const char* pin);
+    void changeTime(const char* epoch);
+    void printLine(const char* text);
+    
+    /**
+     * @brief Check that a string is 1..MAX_PASSWORD_LENGTH digits
+     */
+    static bool isValidPin(const char* pin);
+    
+    /**
+     * @brief Parse a user ID: decimal digits only, below AuditSink::NO_USER
+     */
+    static bool parseUserId(const char* text, uint16_t& userId);
+};
+
+#endif // MAINTENANCE_CONSOLE_H
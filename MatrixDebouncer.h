@@ -0,0 +1,75 @@
+/**
+ * @file MatrixDebouncer.h
+ * @brief Vertical-counter debouncer for a whole key matrix
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * Every key owns one bit of a 16-bit word and a 2-bit counter spread over two
+ * more words, so one scan updates all keys with a handful of bitwise ops.
+ * A key changes state after SAMPLES consecutive scans that disagree with it;
+ * any agreeing scan in between resets its counter.
+ */
+
+#ifndef MATRIX_DEBOUNCER_H
+#define MATRIX_DEBOUNCER_H
+
+#include <cstdint>
+
+/**
+ * @class MatrixDebouncer
+ * @brief Debounces up to 16 keys in parallel
+ */
+class MatrixDebouncer {
+public:
+    static const int SAMPLES = 4;   // Consecutive scans needed to flip a key
+    
+    MatrixDebouncer() : _state(0), _cnt0(0), _cnt1(0) {}
+    
+    /**
+     * @brief Feed one raw scan
+     * @param raw Bit set = key reads as down
+     * @return Bits whose debounced state flipped on this scan
+     */
+    uint16_t update(uint16_t raw) {
+        uint16_t delta = raw ^ _state;
+        
+        // Count each disagreeing key 0 -> 1 -> 2 -> 3 -> 0, clear agreeing ones
+        _cnt1 = (_cnt1 ^ _cnt0) & delta;
+        _cnt0 = ~_cnt0 & delta;
+        
+        // Wrapping back to zero while still disagreeing means SAMPLES in a row
+        uint16_t toggled = delta & ~(_cnt0 | _cnt1);
+        _state ^= toggled;
+        return toggled;
+    }
+    
+    /**
+     * @brief Debounced key state, bit set = key down
+     */
+    uint16_t state() const {
+        return _state;
+    }
+    
+    /**
+     * @brief Check whether any key is part way through a transition
+     */
+    bool settling() const {
+        return (_cnt0 | _cnt1) != 0;
+    }
+    
+    /**
+     * @brief Forget all state (every key up, counters cleared)
+     */
+    void reset() {
+        _state = 0;
+        _cnt0 = 0;
+        _cnt1 = 0;
+    }
+    
+private:
+    uint16_t _state;    // Debounced key bits
+    uint16_t _cnt0;     // Counter bit 0 per key
+    uint16_t _cnt1;     // Counter bit 1 per key
+};
+
+#endif // MATRIX_DEBOUNCER_H
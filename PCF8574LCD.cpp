@@ -0,0 +1,159 @@
+/**
+ * @file PCF8574LCD.cpp
+ * @brief Implementation of the batched PCF8574 HD44780 driver
+ */
+
+#include "PCF8574LCD.h"
+
+// HD44780 commands
+#define LCD_CMD_CLEAR        0x01
+#define LCD_CMD_ENTRY_MODE   0x06    // Increment, no shift
+#define LCD_CMD_DISPLAY_ON   0x0C    // Display on, cursor off, blink off
+#define LCD_CMD_FUNCTION_SET 0x28    // 4-bit bus, 2 lines, 5x8 font
+#define LCD_CMD_SET_CGRAM    0x40
+#define LCD_CMD_SET_DDRAM    0x80
+
+PCF8574LCD::PCF8574LCD(I2C& i2c, uint8_t address)
+    : _i2c(i2c), _address(address << 1), _backlight(PIN_BACKLIGHT), _length(0), _rs(0),
+      _bytesSent(0), _writeErrors(0) {
+}
+
+void PCF8574LCD::queueNibble(uint8_t nibble, uint8_t rs) {
+    uint8_t bits = (nibble << 4) | rs | _backlight;
+    
+    // RS has to settle before EN rises - give it one expander write of its own
+    if (_length == 0 || rs != _rs) {
+        _burst[_length++] = bits;
+        _rs = rs;
+    }
+    
+    // The controller latches on the falling edge of EN
+    _burst[_length++] = bits | PIN_EN;
+    _burst[_length++] = bits;
+}
+
+void PCF8574LCD::queueByte(uint8_t value, uint8_t rs) {
+    queueNibble(value >> 4, rs);
+    queueNibble(value & 0x0F, rs);
+}
+
+void PCF8574LCD::flush() {
+    if (_length == 0) {
+        return;
+    }
+    // One I2C byte takes longer than the 37us a command needs, so the
+    // controller keeps up with a back-to-back burst at 100 and 400 kHz
+    bool sent;
+#if DEVICE_I2C_ASYNCH
+    _transferFlags.clear(FLAG_TRANSFER_DONE);
+    _transferEvent = 0;
+    if (_i2c.transfer(_address, reinterpret_cast<const char*>(_burst), _length, nullptr, 0,
+                      callback(this, &PCF8574LCD::onTransferDone), I2C_EVENT_ALL) == 0) {
+        // _burst has to stay untouched until the transfer is over
+        uint32_t flags = _transferFlags.wait_any_for(FLAG_TRANSFER_DONE,
+                                                     std::chrono::milliseconds(LCD_I2C_TIMEOUT_MS));
+        if (flags & osFlagsError) {
+            _i2c.abort_transfer();
+        }
+        int event = _transferEvent;
+        sent = !(flags & osFlagsError) && (event & I2C_EVENT_TRANSFER_COMPLETE) &&
+               !(event & (I2C_EVENT_ERROR | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK));
+    } else {
+        // Bus busy with another asynchronous user - send it the blocking way
+        sent = _i2c.write(_address, reinterpret_cast<const char*>(_burst), _length) == 0;
+    }
+#else
+    sent = _i2c.write(_address, reinterpret_cast<const char*>(_burst), _length) == 0;
+#endif
+    if (sent) {
+        _bytesSent += _length;
+    } else {
+        _writeErrors++;
+    }
+    _length = 0;
+}
+
+#if DEVICE_I2C_ASYNCH
+void PCF8574LCD::onTransferDone(int event) {
+    // Errors (no ACK from the backpack) end the transfer too
+    _transferEvent = event;
+    _transferFlags.set(FLAG_TRANSFER_DONE);
+}
+#endif
+
+void PCF8574LCD::command(uint8_t value) {
+    queueByte(value, 0);
+    flush();
+}
+
+void PCF8574LCD::init() {
+    _i2c.frequency(LCD_I2C_FREQUENCY_HZ);
+    
+    // Wait for the controller to finish its own power-on reset. Counted from
+    // reset, so the wait overlaps whatever ran before the display came up
+    ThisThread::sleep_until(Kernel::Clock::time_point(50ms));
+    
+    // Force 8-bit mode three times (whatever state it was left in), then switch to 4-bit
+    queueNibble(0x03, 0);
+    flush();
+    ThisThread::sleep_for(5ms);
+    queueNibble(0x03, 0);
+    flush();
+    wait_us(150);
+    queueNibble(0x03, 0);
+    flush();
+    wait_us(150);
+    queueNibble(0x02, 0);
+    flush();
+    wait_us(150);
+    
+    // Remaining setup fits in one burst
+    queueByte(LCD_CMD_FUNCTION_SET, 0);
+    queueByte(LCD_CMD_DISPLAY_ON, 0);
+    queueByte(LCD_CMD_ENTRY_MODE, 0);
+    flush();
+    
+    clear();
+}
+
+void PCF8574LCD::clear() {
+    command(LCD_CMD_CLEAR);
+    ThisThread::sleep_for(2ms);
+}
+
+void PCF8574LCD::write(int column, int row, const char* text, int length) {
+    if (row < 0 || row >= LCD_LINES || column < 0 || column >= LCD_COLUMNS) {
+        return;
+    }
+    if (length > LCD_COLUMNS - column) {
+        length = LCD_COLUMNS - column;
+    }
+    
+    // Line 2 starts at DDRAM 0x40 on two-line displays
+    queueByte(LCD_CMD_SET_DDRAM | ((row ? 0x40 : 0x00) + column), 0);
+    for (int i = 0; i < length; i++) {
+        queueByte(static_cast<uint8_t>(text[i]), PIN_RS);
+    }
+    flush();
+}
+
+void PCF8574LCD::defineGlyph(int slot, const uint8_t rows[8]) {
+    if (slot < 0 || slot > 7) {
+        return;
+    }
+    
+    // Leaves the address counter in CGRAM - write() always sets DDRAM first
+    queueByte(LCD_CMD_SET_CGRAM | (slot << 3), 0);
+    for (int i = 0; i < 8; i++) {
+        queueByte(rows[i] & 0x1F, PIN_RS);
+    }
+    flush();
+}
+
+void PCF8574LCD::setBacklight(bool on) {
+    _backlight = on ? PIN_BACKLIGHT : 0;
+    
+    // Expander write with EN low: only the backlight output changes
+    _burst[_length++] = _backlight;
+    flush();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file PCF8574LCD.h
+ * @brief HD44780 character LCD driver for PCF8574 I2C backpacks
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * The backpack exposes the HD44780 4-bit bus as the eight expander outputs, so
+ * every byte for the controller becomes a sequence of expander writes with EN
+ * toggling. This driver packs the whole sequence for a cursor move plus a run of
+ * characters into one buffer and sends it as a single i2c.write() burst, instead
+ * of one transaction per nibble.
+ * 
+ * On targets with DEVICE_I2C_ASYNCH the burst goes out through I2C::transfer()
+ * and the calling thread sleeps until the completion interrupt, so the CPU is free
+ * while the bus is busy and a hung display only costs LCD_I2C_TIMEOUT_MS. A
+ * transfer that cannot start is sent with a blocking write instead. A burst the
+ * display did not take is counted in writeErrors(), so the framebuffer can
+ * stop trusting its shadow copy.
+ * 
+ * Expander wiring (common LCM1602 backpack): P0=RS P1=RW P2=EN P3=backlight P4-P7=D4-D7
+ */
+
+#ifndef PCF8574_LCD_H
+#define PCF8574_LCD_H
+
+#include "mbed.h"
+#include "config.h"  // LCD_COLUMNS, LCD_LINES, LCD_I2C_FREQUENCY_HZ
+
+/**
+ * @class PCF8574LCD
+ * @brief Batched-write HD44780 driver over a PCF8574 expander
+ */
+class PCF8574LCD {
+public:
+    /**
+     * @brief Constructor (no bus traffic until init())
+     * @param i2c Bus the backpack is on
+     * @param address 7-bit expander address (0x27 for PCF8574, 0x3F for PCF8574A)
+     */
+    PCF8574LCD(I2C& i2c, uint8_t address);
+    
+    /**
+     * @brief Set the bus speed and run the HD44780 4-bit initialisation sequence
+     * Blocks for about 60ms (power-on and command delays from the datasheet).
+     */
+    void init();
+    
+    /**
+     * @brief Clear the display (blocks ~2ms for the controller)
+     */
+    void clear();
+    
+    /**
+     * @brief Write a run of characters starting at a cell, in one I2C burst
+     * @param column Start column
+     * @param row Line
+     * @param text Characters (not NUL-terminated)
+     * @param length Number of characters, clipped to the end of the line
+     */
+    void write(int column, int row, const char* text, int length);
+    
+    /**
+     * @brief Load a custom character into CGRAM, in one I2C burst
+     * Cells showing character code slot change with it.
+     * @param slot CGRAM slot 0-7
+     * @param rows Eight pixel rows, top first, five low bits per row
+     */
+    void defineGlyph(int slot, const uint8_t rows[8]);
+    
+    /**
+     * @brief Switch the backlight (takes effect immediately)
+     */
+    void setBacklight(bool on);
+    
+    /**
+     * @brief Total bytes the display acknowledged, address bytes excluded
+     */
+    uint32_t bytesSent() const {
+        return _bytesSent;
+    }
+    
+    /**
+     * @brief Bursts lost to a NACK, a bus error or LCD_I2C_TIMEOUT_MS
+     */
+    uint32_t writeErrors() const {
+        return _writeErrors;
+    }
+    
+private:
+    // Expander bits
+    static const uint8_t PIN_RS = 0x01;
+    static const uint8_t PIN_EN = 0x04;
+    static const uint8_t PIN_BACKLIGHT = 0x08;
+    
+    // Worst case burst: setup byte per RS change + 4 bytes per controller byte
+    static const int BURST_SIZE = 2 + (LCD_COLUMNS + 1) * 4;
+    static_assert(BURST_SIZE >= 2 + 9 * 4, "A CGRAM command and 8 rows have to fit in one burst");
+    
+    I2C& _i2c;
+    int _address;               // 8-bit (shifted) address for mbed I2C
+    uint8_t _backlight;         // PIN_BACKLIGHT or 0
+    uint8_t _burst[BURST_SIZE];
+    int _length;                // Bytes queued in _burst
+    uint8_t _rs;                // RS level of the last queued byte
+    uint32_t _bytesSent;
+    uint32_t _writeErrors;
+    
+#if DEVICE_I2C_ASYNCH
+    static const uint32_t FLAG_TRANSFER_DONE = 1;
+    EventFlags _transferFlags;
+    volatile int _transferEvent;    // I2C_EVENT_* of the last transfer
+    
+    /**
+     * @brief Asynchronous transfer completion (interrupt context)
+     */
+    void onTransferDone(int event);
+#endif
+    
+    /**
+     * @brief Queue one controller byte as two EN-strobed nibbles
+     * @param value Command or data byte
+     * @param rs PIN_RS for data, 0 for commands
+     */
+    void queueByte(uint8_t value, uint8_t rs);
+    
+    /**
+     * @brief Queue a single EN-strobed nibble (used during 8-bit to 4-bit init)
+     */
+    void queueNibble(uint8_t nibble, uint8_t rs);
+    
+    /**
+     * @brief Send everything queued as one transaction
+     */
+    void flush();
+    
+    /**
+     * @brief Send one command byte right away
+     */
+    void command(uint8_t value);
+};
+
+#endif // PCF8574_LCD_H
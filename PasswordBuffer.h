@@ -0,0 +1,99 @@
+/**
+ * @file PasswordBuffer.h
+ * @brief Fixed-capacity buffer for the digits being entered
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * Replaces a growing std::string: storage is a member array, nothing is ever
+ * allocated, matches() takes the same time whatever the input, and clear()
+ * wipes the digits rather than just resetting the length.
+ */
+
+#ifndef PASSWORD_BUFFER_H
+#define PASSWORD_BUFFER_H
+
+#include <cstddef>
+#include <cstring>
+
+#include "Secure.h"
+
+/**
+ * @class PasswordBuffer
+ * @brief Digit entry buffer with constant-time comparison
+ * @tparam Capacity Maximum number of characters (MAX_PASSWORD_LENGTH)
+ */
+template <size_t Capacity>
+class PasswordBuffer {
+public:
+    PasswordBuffer() : _length(0) {
+        secureWipe(_chars, sizeof(_chars));
+    }
+    
+    ~PasswordBuffer() {
+        clear();
+    }
+    
+    /**
+     * @brief Append a character
+     * @return false if the buffer is full (character dropped)
+     */
+    bool append(char c) {
+        if (_length >= Capacity) {
+            return false;
+        }
+        _chars[_length++] = c;
+        return true;
+    }
+    
+    /**
+     * @brief Wipe every character and reset the length
+     */
+    void clear() {
+        secureWipe(_chars, sizeof(_chars));
+        _length = 0;
+    }
+    
+    size_t length() const {
+        return _length;
+    }
+    
+    bool empty() const {
+        return _length == 0;
+    }
+    
+    bool full() const {
+        return _length >= Capacity;
+    }
+    
+    /**
+     * @brief Raw characters (not NUL-terminated, unused cells are zero)
+     */
+    const char* data() const {
+        return _chars;
+    }
+    
+    /**
+     * @brief Compare with a NUL-terminated secret in constant time
+     * Always compares the whole capacity, so the time depends neither on the
+     * entered digits nor on where they first differ from the secret.
+     * @param expected Secret, at most Capacity characters
+     */
+    bool matches(const char* expected) const {
+        char padded[Capacity];
+        size_t expectedLength = strnlen(expected, Capacity + 1);
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, expected, expectedLength < Capacity ? expectedLength : Capacity);
+        
+        // Fold the length check into the same comparison instead of returning early
+        bool equal = constantTimeEquals(_chars, padded, Capacity);
+        bool lengthOk = (_length ^ expectedLength) == 0;
+        secureWipe(padded, sizeof(padded));
+        return equal & lengthOk;
+    }
+    
+private:
+    char _chars[Capacity];      // Unused cells kept at zero
+    size_t _length;
+};
+
+#endif // PASSWORD_BUFFER_H
@@ -0,0 +1,380 @@
+/**
+ * @file PinStore.cpp
+ * @brief Implementation of the flash-backed PIN store
+ */
+
+#include "PinStore.h"
+#include "Secure.h"
+#include "mbedtls/sha256.h"
+
+#if DEVICE_TRNG
+#include "hal/trng_api.h"
+#endif
+
+#include <cstring>
+
+PinStore::PinStore()
+    : _ready(false), _bankSize(0), _bank(0), _count(0), _lastHashUs(0) {
+    memset(&_header, 0, sizeof(_header));
+    _bankAddress[0] = _bankAddress[1] = 0;
+}
+
+bool PinStore::init() {
+    _mutex.lock();
+    if (_flash.init() != 0) {
+        _mutex.unlock();
+        return false;
+    }
+    
+    // Two banks at the very end of internal flash, each a whole number of sectors
+    uint32_t flashEnd = _flash.get_flash_start() + _flash.get_flash_size();
+    uint32_t sector = _flash.get_sector_size(flashEnd - 1);
+    uint32_t needed = RECORDS_OFFSET + PIN_STORE_CAPACITY * sizeof(Record);
+    _bankSize = (needed + sector - 1) / sector * sector;
+    _bankAddress[1] = flashEnd - _bankSize;
+    _bankAddress[0] = _bankAddress[1] - _bankSize;
+    if (_bankAddress[0] < FLASHIAP_APP_ROM_END_ADDR) {
+        _mutex.unlock();
+        return false;  // Firmware image runs into the store
+    }
+    
+    // Newest valid header wins; a bank without one was never finished
+    Header headers[2];
+    bool valid[2] = {readHeader(0, headers[0]), readHeader(1, headers[1])};
+    if (valid[0] || valid[1]) {
+        _bank = (valid[0] && (!valid[1] || headers[0].sequence > headers[1].sequence)) ? 0 : 1;
+        _header = headers[_bank];
+        _count = countLive();
+        _ready = true;
+        _mutex.unlock();
+        return true;
+    }
+    
+    // First boot: fresh salt, and the compiled-in PASSWORD as the admin PIN
+    memset(&_header, 0, sizeof(_header));
+    _header.sequence = 0;
+    generateSalt(_header.salt, sizeof(_header.salt));
+    _header.iterations = calibrateIterations();
+    if (!format(0)) {
+        _mutex.unlock();
+        return false;
+    }
+    _ready = true;
+    _mutex.unlock();
+    
+    return setPin(ADMIN_USER_ID, PASSWORD, sizeof(PASSWORD) - 1) == OK;
+}
+
+// ==================== LOOKUP ====================
+
+bool PinStore::verify(const char* pin, size_t length, uint16_t* userId) {
+    uint8_t hash[HASH_SIZE];
+    
+    _mutex.lock();
+    bool found = false;
+    if (_ready) {
+        hashPin(pin, length, hash);
+        found = lookup(hash, userId);
+    }
+    _mutex.unlock();
+    
+    secureWipe(hash, sizeof(hash));
+    return found;
+}
+
+bool PinStore::lookup(const uint8_t* hash, uint16_t* userId) {
+    uint32_t match = 0;
+    uint32_t matchId = 0;
+    
+    // Always both buckets, no early exit: the time does not depend on
+    // whether or where the PIN is stored
+    for (uint32_t i = 0; i < PROBE_SLOTS; i++) {
+        Record record;
+        readRecord(_bank, probeSlot(hash, i), record);
+        uint32_t hit = (record.state == STATE_LIVE) & constantTimeEquals(record.hash, hash, HASH_SIZE);
+        uint32_t mask = 0u - hit;
+        matchId |= record.userId & mask;
+        match |= hit;
+    }
+    
+    if (match && userId) {
+        *userId = matchId;
+    }
+    return match != 0;
+}
+
+bool PinStore::findUser(uint16_t userId, const uint8_t* exceptHash, uint32_t* slot) {
+    for (uint32_t i = 0; i < PIN_STORE_CAPACITY; i++) {
+        Record record;
+        readRecord(_bank, i, record);
+        if (record.state == STATE_LIVE && record.userId == userId &&
+            !(exceptHash && memcmp(record.hash, exceptHash, HASH_SIZE) == 0)) {
+            *slot = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PinStore::forEachUser(Callback<void(uint16_t)> visit) {
+    _mutex.lock();
+    for (uint32_t i = 0; _ready && i < PIN_STORE_CAPACITY; i++) {
+        Record record;
+        readRecord(_bank, i, record);
+        if (record.state == STATE_LIVE) {
+            visit(record.userId);
+        }
+    }
+    _mutex.unlock();
+}
+
+// ==================== UPDATES ====================
+
+PinStore::Status PinStore::setPin(uint16_t userId, const char* pin, size_t length) {
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.state = STATE_LIVE;
+    record.userId = userId;
+    
+    _mutex.lock();
+    if (!_ready) {
+        _mutex.unlock();
+        return FLASH_ERROR;
+    }
+    
+    hashPin(pin, length, record.hash);
+    uint16_t owner;
+    if (lookup(record.hash, &owner)) {
+        _mutex.unlock();
+        secureWipe(&record, sizeof(record));
+        return owner == userId ? OK : DUPLICATE;
+    }
+    
+    // Add the new record before retiring the old one - a reset in between
+    // leaves the user with two valid PINs rather than none
+    Status status = insert(record) ? OK : FULL;
+    uint32_t oldSlot;
+    if (status == OK && findUser(userId, record.hash, &oldSlot)) {
+        static const uint8_t zeros[8] = {0};
+        if (_flash.program(zeros, recordAddress(_bank, oldSlot), sizeof(zeros)) != 0) {
+            status = FLASH_ERROR;
+        } else {
+            _count--;
+        }
+    }
+    _mutex.unlock();
+    
+    secureWipe(&record, sizeof(record));
+    return status;
+}
+
+PinStore::Status PinStore::remove(uint16_t userId) {
+    static const uint8_t zeros[8] = {0};
+    
+    _mutex.lock();
+    Status status = FLASH_ERROR;
+    uint32_t slot;
+    if (!_ready) {
+        status = FLASH_ERROR;
+    } else if (!findUser(userId, nullptr, &slot)) {
+        status = NOT_FOUND;
+    } else if (_flash.program(zeros, recordAddress(_bank, slot), sizeof(zeros)) == 0) {
+        // STM32L4 flash accepts all-zero over written cells: the tombstone needs no erase
+        _count--;
+        status = OK;
+    }
+    _mutex.unlock();
+    return status;
+}
+
+bool PinStore::insert(const Record& record) {
+    if (place(_bank, record)) {
+        _count++;
+        return true;
+    }
+    
+    // Both buckets full of live records and tombstones - compact and retry
+    if (!rebuild() || !place(_bank, record)) {
+        return false;
+    }
+    _count++;
+    return true;
+}
+
+bool PinStore::place(int bank, const Record& record) {
+    // First free slot and number of free slots in each candidate bucket
+    uint32_t freeSlot[2] = {0, 0};
+    int freeCount[2] = {0, 0};
+    for (int choice = 0; choice < 2; choice++) {
+        uint32_t start = bucketStart(record.hash, choice);
+        for (uint32_t i = 0; i < PIN_STORE_BUCKET_SLOTS; i++) {
+            Record existing;
+            readRecord(bank, start + i, existing);
+            if (existing.state == STATE_EMPTY && freeCount[choice]++ == 0) {
+                freeSlot[choice] = start + i;
+            }
+        }
+    }
+    
+    // The emptier bucket keeps the load even
+    int choice = freeCount[1] > freeCount[0] ? 1 : 0;
+    if (freeCount[choice] == 0) {
+        return false;
+    }
+    return _flash.program(&record, recordAddress(bank, freeSlot[choice]), sizeof(record)) == 0;
+}
+
+bool PinStore::rebuild() {
+    int target = 1 - _bank;
+    if (_flash.erase(_bankAddress[target], _bankSize) != 0) {
+        return false;
+    }
+    
+    // Copy the live records; tombstones are left behind
+    for (uint32_t i = 0; i < PIN_STORE_CAPACITY; i++) {
+        Record record;
+        readRecord(_bank, i, record);
+        if (record.state == STATE_LIVE && !place(target, record)) {
+            secureWipe(&record, sizeof(record));
+            _flash.erase(_bankAddress[target], _bankSize);
+            return false;
+        }
+        secureWipe(&record, sizeof(record));
+    }
+    
+    // The header makes the new bank valid, so it goes last
+    Header header = _header;
+    header.sequence = _header.sequence + 1;
+    header.crc = headerCrc(header);
+    if (_flash.program(&header, _bankAddress[target], sizeof(header)) != 0) {
+        _flash.erase(_bankAddress[target], _bankSize);
+        return false;
+    }
+    
+    _flash.erase(_bankAddress[_bank], _bankSize);
+    _bank = target;
+    _header = header;
+    return true;
+}
+
+bool PinStore::format(int bank) {
+    if (_flash.erase(_bankAddress[bank], _bankSize) != 0) {
+        return false;
+    }
+    
+    _header.magic = MAGIC;
+    _header.version = VERSION;
+    _header.headerSize = sizeof(Header);
+    _header.capacity = PIN_STORE_CAPACITY;
+    _header.crc = headerCrc(_header);
+    if (_flash.program(&_header, _bankAddress[bank], sizeof(_header)) != 0) {
+        return false;
+    }
+    _bank = bank;
+    _count = 0;
+    return true;
+}
+
+// ==================== HELPERS ====================
+
+void PinStore::readRecord(int bank, uint32_t slot, Record& record) {
+    // Internal flash is memory mapped: this is a 24-byte copy
+    _flash.read(&record, recordAddress(bank, slot), sizeof(record));
+}
+
+bool PinStore::readHeader(int bank, Header& header) {
+    _flash.read(&header, _bankAddress[bank], sizeof(header));
+    return header.magic == MAGIC && header.version == VERSION &&
+           header.headerSize == sizeof(Header) && header.capacity == PIN_STORE_CAPACITY &&
+           header.crc == headerCrc(header);
+}
+
+uint32_t PinStore::headerCrc(const Header& header) const {
+    MbedCRC<POLY_32BIT_ANSI, 32> crc32;
+    uint32_t crc = 0;
+    crc32.compute(&header, offsetof(Header, crc), &crc);
+    return crc;
+}
+
+void PinStore::hashPin(const char* pin, size_t length, uint8_t* hash) {
+    Timer timer;
+    timer.start();
+    
+    uint8_t digest[32];
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts_ret(&ctx, 0);
+    mbedtls_sha256_update_ret(&ctx, _header.salt, sizeof(_header.salt));
+    mbedtls_sha256_update_ret(&ctx, reinterpret_cast<const unsigned char*>(pin), length);
+    mbedtls_sha256_finish_ret(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+    stretch(digest, _header.salt, kdfIterations() - 1);
+    
+    memcpy(hash, digest, HASH_SIZE);
+    secureWipe(digest, sizeof(digest));
+    _lastHashUs = timer.elapsed_time().count();
+}
+
+void PinStore::stretch(uint8_t* digest, const uint8_t* salt, uint32_t rounds) {
+    // digest = SHA-256(digest || salt), one 48-byte block per round
+    uint8_t block[32 + PIN_SALT_SIZE];
+    memcpy(block + 32, salt, PIN_SALT_SIZE);
+    for (uint32_t i = 0; i < rounds; i++) {
+        memcpy(block, digest, 32);
+        mbedtls_sha256_ret(block, sizeof(block), digest, 0);
+    }
+    secureWipe(block, sizeof(block));
+}
+
+uint32_t PinStore::calibrateIterations() {
+#if PIN_KDF_ITERATIONS > 0
+    return PIN_KDF_ITERATIONS;
+#else
+    // Time a fixed number of rounds and scale to the budget
+    static const uint32_t SAMPLE_ROUNDS = 64;
+    uint8_t digest[32] = {0};
+    Timer timer;
+    timer.start();
+    stretch(digest, _header.salt, SAMPLE_ROUNDS);
+    uint32_t elapsedUs = timer.elapsed_time().count();
+    if (elapsedUs == 0) {
+        elapsedUs = 1;
+    }
+    
+    uint64_t rounds = (uint64_t)PIN_KDF_BUDGET_MS * 1000 * SAMPLE_ROUNDS / elapsedUs;
+    if (rounds < PIN_KDF_MIN_ITERATIONS) {
+        rounds = PIN_KDF_MIN_ITERATIONS;
+    }
+    return rounds > 0xFFFFFF ? 0xFFFFFF : (uint32_t)rounds;
+#endif
+}
+
+void PinStore::generateSalt(uint8_t* salt, size_t length) {
+#if DEVICE_TRNG
+    trng_t trng;
+    size_t produced = 0;
+    trng_init(&trng);
+    while (produced < length) {
+        size_t got = 0;
+        trng_get_bytes(&trng, salt + produced, length - produced, &got);
+        produced += got;
+    }
+    trng_free(&trng);
+#else
+    // No entropy source: timer jitter only. Still unique per unit, not secret.
+    for (size_t i = 0; i < length; i++) {
+        wait_us(37 + (i * 13) % 29);
+        salt[i] = static_cast<uint8_t>(us_ticker_read() ^ (us_ticker_read() >> 8));
+    }
+#endif
+}
+
+size_t PinStore::countLive() {
+    size_t live = 0;
+    for (uint32_t i = 0; i < PIN_STORE_CAPACITY; i++) {
+        Record record;
+        readRecord(_bank, i, record);
+        live += record.state == STATE_LIVE;
+    }
+    return live;
+}
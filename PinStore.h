@@ -0,0 +1,222 @@
+/**
+ * @file PinStore.h
+ * @brief Flash-backed store of salted user PIN hashes
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * PINs are kept as an iterated, salted SHA-256 of the PIN in an open-addressed hash table in
+ * internal flash, indexed by the hash itself - a user is identified by their PIN
+ * alone, so PINs are unique. Each hash has two candidate buckets of
+ * PIN_STORE_BUCKET_SLOTS slots (taken from different hash bytes) and goes into
+ * the emptier one. A lookup always reads both buckets and compares every slot in
+ * constant time, so it costs the same few microseconds whether the PIN is known
+ * or not, and no matter how full the table is. Two choices keep a fixed window
+ * from overflowing long before the table is full, which plain linear probing
+ * does not.
+ * 
+ * Flash can only be programmed once per erase, so records are never rewritten:
+ * deleting one zeroes its first double word (a tombstone) and two full buckets
+ * trigger a rebuild into the second bank, which drops the tombstones. The bank
+ * header is written last, so a rebuild cut short by a reset leaves the old bank
+ * in charge.
+ * 
+ * The iteration count is calibrated to PIN_KDF_BUDGET_MS when the store is
+ * formatted and saved in the header - every record depends on it, so it can not
+ * change at a later boot. SHA-256 goes through Mbed TLS, which uses the target's
+ * HASH engine when the port provides MBEDTLS_SHA256_ALT; header CRCs use the CRC
+ * peripheral through MbedCRC.
+ */
+
+#ifndef PIN_STORE_H
+#define PIN_STORE_H
+
+#include "mbed.h"
+#include "DoorIO.h"    // PinVerifier
+#include "config.h"  // PIN_STORE_CAPACITY, PIN_STORE_BUCKET_SLOTS, PIN_SALT_SIZE
+
+/**
+ * @class PinStore
+ * @brief Hashed PIN table in two alternating flash banks
+ */
+class PinStore : public PinVerifier {
+    static_assert((PIN_STORE_CAPACITY & (PIN_STORE_CAPACITY - 1)) == 0,
+                  "PIN_STORE_CAPACITY must be a power of two");
+    static_assert((PIN_STORE_BUCKET_SLOTS & (PIN_STORE_BUCKET_SLOTS - 1)) == 0 &&
+                  PIN_STORE_BUCKET_SLOTS * 2 <= PIN_STORE_CAPACITY,
+                  "PIN_STORE_BUCKET_SLOTS must be a power of two, at most half the table");
+    
+public:
+    static const size_t HASH_SIZE = 16;     // Stored bytes of the SHA-256 digest
+    
+    /**
+     * @brief Result of a store update
+     */
+    enum Status {
+        OK = 0,
+        NOT_FOUND,          // No record for this user
+        DUPLICATE,          // Another user already has this PIN
+        FULL,               // Both buckets full, even after a rebuild
+        FLASH_ERROR         // Erase/program failed or store not initialised
+    };
+    
+    PinStore();
+    
+    /**
+     * @brief Open the store, formatting it on first boot
+     * A fresh store gets a random salt and one record: PASSWORD for ADMIN_USER_ID.
+     * @return false if the flash region is unusable
+     */
+    bool init();
+    
+    /**
+     * @brief Check a PIN (constant time)
+     * @param pin Digits, not NUL-terminated
+     * @param length Number of digits
+     * @param userId Set to the owner of the PIN on success (may be nullptr)
+     * @return true if the PIN belongs to a user
+     */
+    bool verify(const char* pin, size_t length, uint16_t* userId = nullptr) override;
+    
+    /**
+     * @brief Add a user or change their PIN
+     */
+    Status setPin(uint16_t userId, const char* pin, size_t length);
+    
+    /**
+     * @brief Delete a user
+     */
+    Status remove(uint16_t userId);
+    
+    /**
+     * @brief Call a function for every stored user (maintenance only, linear scan)
+     */
+    void forEachUser(Callback<void(uint16_t)> visit);
+    
+    /**
+     * @brief Number of stored users
+     */
+    size_t count() const {
+        return _count;
+    }
+    
+    /**
+     * @brief Lowest flash address used by the store (0 if init() never got that far)
+     * Other flash users go below this.
+     */
+    uint32_t regionStart() const {
+        return _bankAddress[0];
+    }
+    
+    static size_t capacity() {
+        return PIN_STORE_CAPACITY;
+    }
+    
+    /**
+     * @brief SHA-256 rounds per PIN hash
+     */
+    uint32_t kdfIterations() const {
+        return _header.iterations ? _header.iterations : 1;
+    }
+    
+    /**
+     * @brief Duration of the most recent PIN hash in microseconds
+     */
+    uint32_t lastHashUs() const {
+        return _lastHashUs;
+    }
+    
+    /**
+     * @brief true if SHA-256 runs on a hardware engine
+     */
+    static bool hardwareHash() {
+#if defined(MBEDTLS_SHA256_ALT)
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+private:
+    /**
+     * @brief Bank header (first bytes of each bank, programmed last)
+     */
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t capacity;
+        uint32_t sequence;              // Higher wins between the two banks
+        uint8_t salt[PIN_SALT_SIZE];
+        uint32_t iterations;            // KDF rounds (0 in early stores = 1)
+        uint8_t reserved[24];
+        uint32_t crc;                   // CRC-32 of everything above
+    };
+    
+    /**
+     * @brief One table slot - 24 bytes, a multiple of the 8-byte program unit
+     * 128 hash bits are far more than the PIN space, so truncating costs nothing.
+     */
+    struct Record {
+        uint32_t state;                 // STATE_EMPTY, STATE_LIVE or 0 (deleted)
+        uint16_t userId;
+        uint16_t reserved;
+        uint8_t hash[HASH_SIZE];
+    };
+    
+    static const uint32_t MAGIC = 0x50494E53;       // 'PINS'
+    static const uint16_t VERSION = 1;
+    static const uint32_t STATE_EMPTY = 0xFFFFFFFF; // Erased flash
+    static const uint32_t STATE_LIVE = 0x4C495645;  // 'LIVE'
+    static const uint32_t RECORDS_OFFSET = 64;
+    
+    FlashIAP _flash;
+    Mutex _mutex;
+    bool _ready;
+    uint32_t _bankAddress[2];
+    uint32_t _bankSize;
+    int _bank;                      // Active bank
+    Header _header;                 // RAM copy of the active header
+    size_t _count;                  // Live records in the active bank
+    uint32_t _lastHashUs;
+    
+    uint32_t recordAddress(int bank, uint32_t slot) const {
+        return _bankAddress[bank] + RECORDS_OFFSET + slot * sizeof(Record);
+    }
+    
+    static const uint32_t BUCKETS = PIN_STORE_CAPACITY / PIN_STORE_BUCKET_SLOTS;
+    static const uint32_t PROBE_SLOTS = 2 * PIN_STORE_BUCKET_SLOTS;  // Read by every lookup
+    
+    /**
+     * @brief First slot of one of the two candidate buckets of a hash
+     * @param choice 0 or 1
+     */
+    static uint32_t bucketStart(const uint8_t* hash, int choice) {
+        const uint8_t* b = hash + choice * 4;
+        uint32_t h = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+        return (h & (BUCKETS - 1)) * PIN_STORE_BUCKET_SLOTS;
+    }
+    
+    /**
+     * @brief Slot i (0..PROBE_SLOTS-1) of the lookup window of a hash
+     */
+    static uint32_t probeSlot(const uint8_t* hash, uint32_t i) {
+        return bucketStart(hash, i / PIN_STORE_BUCKET_SLOTS) + i % PIN_STORE_BUCKET_SLOTS;
+    }
+    
+    void readRecord(int bank, uint32_t slot, Record& record);
+    bool readHeader(int bank, Header& header);
+    uint32_t headerCrc(const Header& header) const;
+    void hashPin(const char* pin, size_t length, uint8_t* hash);
+    static void stretch(uint8_t* digest, const uint8_t* salt, uint32_t rounds);
+    uint32_t calibrateIterations();
+    bool lookup(const uint8_t* hash, uint16_t* userId);
+    bool findUser(uint16_t userId, const uint8_t* exceptHash, uint32_t* slot);
+    bool place(int bank, const Record& record);
+    bool insert(const Record& record);
+    bool rebuild();
+    bool format(int bank);
+    void generateSalt(uint8_t* salt, size_t length);
+    size_t countLive();
+};
+
+#endif // PIN_STORE_H
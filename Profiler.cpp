@@ -0,0 +1,101 @@
+/**
+ * @file Profiler.cpp
+ * @brief Implementation of the DWT profiler
+ */
+
+#include "Profiler.h"
+#include "TinyFormat.h"
+
+#if ENABLE_PROFILING
+
+ProfileSection* ProfileSection::s_first = nullptr;
+
+void ProfileSection::record(uint32_t cycles) {
+    int bucket = cycles ? 31 - __builtin_clz(cycles) : 0;
+    if (bucket >= BUCKETS) {
+        bucket = BUCKETS - 1;
+    }
+    
+    // Probes may fire in ISRs - keep the update atomic, it is only a few stores
+    core_util_critical_section_enter();
+    if (!_registered) {
+        _registered = true;
+        _next = s_first;
+        s_first = this;
+    }
+    _count++;
+    _total += cycles;
+    if (cycles < _min) {
+        _min = cycles;
+    }
+    if (cycles > _max) {
+        _max = cycles;
+    }
+    if (_histogram[bucket] < 0xFFFF) {
+        _histogram[bucket]++;
+    }
+    core_util_critical_section_exit();
+}
+
+void Profiler::init() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Print cycles as microseconds with one decimal
+ */
+static int formatUs(char* out, size_t size, uint64_t cycles) {
+    uint32_t tenthsOfUs = (uint32_t)(cycles * 10 / (SystemCoreClock / 1000000));
+    return tinySnprintf(out, size, "%lu.%luus", (unsigned long)(tenthsOfUs / 10),
+                    (unsigned long)(tenthsOfUs % 10));
+}
+
+void Profiler::report(Callback<void(const char*)> line) {
+    char text[160];
+    
+    for (ProfileSection* s = ProfileSection::s_first; s; s = s->_next) {
+        // Copy under the lock so an ISR sample can not tear the numbers
+        core_util_critical_section_enter();
+        ProfileSection snapshot = *s;
+        core_util_critical_section_exit();
+        if (snapshot._count == 0) {
+            continue;
+        }
+        
+        int len = tinySnprintf(text, sizeof(text), "%-14s n=%lu min=", snapshot._name,
+                           (unsigned long)snapshot._count);
+        len += formatUs(text + len, sizeof(text) - len, snapshot._min);
+        len += tinySnprintf(text + len, sizeof(text) - len, " avg=");
+        len += formatUs(text + len, sizeof(text) - len, snapshot._total / snapshot._count);
+        len += tinySnprintf(text + len, sizeof(text) - len, " max=");
+        len += formatUs(text + len, sizeof(text) - len, snapshot._max);
+        line(text);
+        
+        // Histogram: only the buckets that have samples, labelled by cycles
+        len = tinySnprintf(text, sizeof(text), "  cycles");
+        for (int b = 0; b < ProfileSection::BUCKETS && len < (int)sizeof(text) - 16; b++) {
+            if (snapshot._histogram[b]) {
+                len += tinySnprintf(text + len, sizeof(text) - len, " 2^%d:%u", b, snapshot._histogram[b]);
+            }
+        }
+        line(text);
+    }
+}
+
+void Profiler::reset() {
+    for (ProfileSection* s = ProfileSection::s_first; s; s = s->_next) {
+        core_util_critical_section_enter();
+        s->_count = 0;
+        s->_min = 0xFFFFFFFF;
+        s->_max = 0;
+        s->_total = 0;
+        for (int b = 0; b < ProfileSection::BUCKETS; b++) {
+            s->_histogram[b] = 0;
+        }
+        core_util_critical_section_exit();
+    }
+}
+
+#endif // ENABLE_PROFILING
@@ -0,0 +1,117 @@
+/**
+ * @file Profiler.h
+ * @brief DWT cycle-counter probes for hot-path timing
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * PROFILE_SCOPE("name") at the top of a block times it with the Cortex-M DWT
+ * cycle counter and folds the result into per-section count, min, max, mean and
+ * a log2 histogram. Probes cost a few dozen cycles and are ISR-safe. With
+ * ENABLE_PROFILING false in config.h the macro expands to nothing.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "config.h"  // ENABLE_PROFILING
+
+#if ENABLE_PROFILING
+
+#include "mbed.h"
+
+/**
+ * @class ProfileSection
+ * @brief Statistics for one named code section
+ * Constant-initialised, so a function-local static needs no guard (safe in ISRs);
+ * it joins the report list on its first sample.
+ */
+class ProfileSection {
+public:
+    static const int BUCKETS = 24;  // Bucket i counts samples of [2^i, 2^(i+1)) cycles
+    
+    constexpr explicit ProfileSection(const char* name)
+        : _name(name), _next(nullptr), _registered(false), _count(0), _min(0xFFFFFFFF), _max(0),
+          _total(0), _histogram{} {}
+    
+    /**
+     * @brief Add one sample
+     * @param cycles Duration in CPU cycles
+     */
+    void record(uint32_t cycles);
+    
+private:
+    friend class Profiler;
+    
+    const char* _name;
+    ProfileSection* _next;
+    bool _registered;
+    uint32_t _count;
+    uint32_t _min;
+    uint32_t _max;
+    uint64_t _total;
+    uint16_t _histogram[BUCKETS];
+    
+    static ProfileSection* s_first;
+};
+
+/**
+ * @class Profiler
+ * @brief Cycle counter setup and reporting
+ */
+class Profiler {
+public:
+    /**
+     * @brief Enable the DWT cycle counter (call once at boot)
+     */
+    static void init();
+    
+    /**
+     * @brief Current cycle count
+     */
+    static uint32_t cycles() {
+        return DWT->CYCCNT;
+    }
+    
+    /**
+     * @brief Format every section, one line per call of the sink
+     * @param line Receives NUL-terminated lines without line endings
+     */
+    static void report(Callback<void(const char*)> line);
+    
+    /**
+     * @brief Clear every section's statistics
+     */
+    static void reset();
+};
+
+/**
+ * @class ScopedProbe
+ * @brief Times the enclosing scope into a section
+ */
+class ScopedProbe {
+public:
+    explicit ScopedProbe(ProfileSection& section)
+        : _section(section), _start(Profiler::cycles()) {}
+    
+    ~ScopedProbe() {
+        _section.record(Profiler::cycles() - _start);
+    }
+    
+private:
+    ProfileSection& _section;
+    uint32_t _start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)                                                             \
+    static ProfileSection PROFILE_CONCAT(_profileSection, __LINE__)(name);             \
+    ScopedProbe PROFILE_CONCAT(_profileProbe, __LINE__)(PROFILE_CONCAT(_profileSection, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif // ENABLE_PROFILING
+
+#endif // PROFILER_H
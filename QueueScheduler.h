@@ -0,0 +1,46 @@
+/**
+ * @file QueueScheduler.h
+ * @brief Scheduler (DoorIO.h) on an Mbed EventQueue
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Deadlines become queue events, so they run in the thread that dispatches the
+ * queue and the core can sleep in between. The kernel clock keeps counting in
+ * tickless STOP mode, like the queue timers.
+ */
+
+#ifndef QUEUE_SCHEDULER_H
+#define QUEUE_SCHEDULER_H
+
+#include "mbed.h"
+#include "DoorIO.h"    // Scheduler
+
+/**
+ * @class QueueScheduler
+ * @brief DoorController deadlines on an EventQueue
+ */
+class QueueScheduler : public Scheduler {
+public:
+    explicit QueueScheduler(EventQueue& queue) : _queue(queue) {}
+    
+    uint32_t nowMs() override {
+        return Kernel::Clock::now().time_since_epoch().count();
+    }
+    
+    int callIn(uint32_t delayMs, Task task, void* context) override {
+        return _queue.call_in(std::chrono::milliseconds(delayMs), task, context);
+    }
+    
+    int callEvery(uint32_t periodMs, Task task, void* context) override {
+        return _queue.call_every(std::chrono::milliseconds(periodMs), task, context);
+    }
+    
+    void cancel(int id) override {
+        _queue.cancel(id);
+    }
+    
+private:
+    EventQueue& _queue;
+};
+
+#endif // QUEUE_SCHEDULER_H
@@ -0,0 +1,95 @@
+/**
+ * @file RuntimeConfig.cpp
+ * @brief Implementation of the flash-backed door settings
+ */
+
+#include "RuntimeConfig.h"
+
+#include <cstring>
+#include <new>
+
+const char* const RuntimeConfig::KEY = "door_cfg";
+
+RuntimeConfig::RuntimeConfig()
+    : _store(nullptr), _start(0), _settings(DoorSettings::defaults()), _source(SOURCE_NO_STORE) {
+}
+
+bool RuntimeConfig::init(uint32_t regionEnd) {
+    if (regionEnd == 0 || regionEnd - CONFIG_STORE_SIZE < FLASHIAP_APP_ROM_END_ADDR) {
+        return false;
+    }
+    _start = regionEnd - CONFIG_STORE_SIZE;
+    FlashIAPBlockDevice* device = new (_deviceStorage) FlashIAPBlockDevice(_start, CONFIG_STORE_SIZE);
+    TDBStore* store = new (_storeStorage) TDBStore(device);
+    if (store->init() != MBED_SUCCESS) {
+        return false;
+    }
+    _store = store;
+    load();
+    return true;
+}
+
+void RuntimeConfig::load() {
+    Record record;
+    size_t actual = 0;
+    int result = _store->get(KEY, &record, sizeof(record), &actual);
+    if (result == MBED_ERROR_ITEM_NOT_FOUND) {
+        _source = SOURCE_DEFAULTS;
+        return;
+    }
+
+    // A longer record (newer firmware) loads as far as this firmware knows it
+    size_t header = sizeof(record) - sizeof(record.settings);
+    DoorSettings loaded = DoorSettings::defaults();
+    if (result == MBED_SUCCESS && actual >= header && record.version == VERSION) {
+        size_t size = record.size < actual - header ? record.size : actual - header;
+        memcpy(&loaded, &record.settings, size < sizeof(loaded) ? size : sizeof(loaded));
+        if (loaded.valid()) {
+            _settings = loaded;
+            _source = SOURCE_STORED;
+            return;
+        }
+    }
+    _source = SOURCE_REJECTED;
+}
+
+bool RuntimeConfig::save() {
+    if (!_store) {
+        return false;
+    }
+    Record record = {VERSION, sizeof(DoorSettings), _settings};
+    return _store->set(KEY, &record, sizeof(record), 0) == MBED_SUCCESS;
+}
+
+RuntimeConfig::Result RuntimeConfig::set(const char* name, uint32_t value) {
+    int index = DoorSettings::find(name);
+    if (index < 0) {
+        return RESULT_UNKNOWN;
+    }
+    if (!_settings.set(index, value)) {
+        return RESULT_RANGE;
+    }
+    bool saved = save();
+    if (saved) {
+        _source = SOURCE_STORED;
+    }
+    if (_onChange) {
+        _onChange(index);
+    }
+    return saved ? RESULT_OK : RESULT_NOT_SAVED;
+}
+
+RuntimeConfig::Result RuntimeConfig::restoreDefaults() {
+    // Field by field, so a door reading them meanwhile never sees a torn value
+    const DoorSettings& defaults = DoorSettings::defaults();
+    for (int i = 0; i < DoorSettings::fieldCount(); i++) {
+        _settings.set(i, defaults.get(i));
+        if (_onChange) {
+            _onChange(i);
+        }
+    }
+    int result = _store ? _store->remove(KEY) : MBED_ERROR_ITEM_NOT_FOUND;
+    bool removed = _store && (result == MBED_SUCCESS || result == MBED_ERROR_ITEM_NOT_FOUND);
+    _source = _store ? SOURCE_DEFAULTS : SOURCE_NO_STORE;
+    return removed ? RESULT_OK : RESULT_NOT_SAVED;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file RuntimeConfig.h
+ * @brief Door settings kept in a KVStore, cached in RAM
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * The settings live as one versioned record in a TDBStore (Mbed's flash
+ * KVStore) on the CONFIG_STORE_SIZE bytes of internal flash below the audit
+ * log. init() reads and validates the record once at boot; from then on the
+ * door reads the RAM copy (settings()) and never touches flash. set() changes
+ * one field in RAM and writes the record back, from the maintenance console.
+ *
+ * A missing record, one of another VERSION or one with a value out of range
+ * leaves the config.h defaults in place (source() tells which). VERSION only
+ * changes when the meaning of a stored field does; fields added at the end of
+ * DoorSettings keep it, and older records load with the new fields defaulted.
+ *
+ * set() blocks on the flash write (and on a TDBStore garbage collection,
+ * which erases sectors) - call it from the console thread, not the door's.
+ */
+
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include "mbed.h"
+#include "FlashIAPBlockDevice.h"
+#include "TDBStore.h"
+#include "DoorSettings.h"
+#include "config.h"  // CONFIG_STORE_SIZE
+
+/**
+ * @class RuntimeConfig
+ * @brief Flash-backed door settings with a RAM cache
+ */
+class RuntimeConfig {
+public:
+    static const uint16_t VERSION = 1;
+
+    enum Source : uint8_t {
+        SOURCE_NO_STORE,            // Flash region unusable - defaults, changes are not saved
+        SOURCE_DEFAULTS,            // Nothing stored yet
+        SOURCE_STORED,              // Loaded from flash
+        SOURCE_REJECTED             // Stored record invalid or of another version - defaults
+    };
+
+    enum Result : uint8_t {
+        RESULT_OK,
+        RESULT_UNKNOWN,             // No such setting
+        RESULT_RANGE,               // Value outside the setting's range, nothing changed
+        RESULT_NOT_SAVED            // Applied, but the flash write failed (lost at reset)
+    };
+
+    RuntimeConfig();
+
+    /**
+     * @brief Open the store and load the settings
+     * @param regionEnd Address just past the store (its sectors are below it)
+     * @return false if the flash region is unusable (the defaults stay in use)
+     */
+    bool init(uint32_t regionEnd);
+
+    /**
+     * @brief The settings in use (valid for the program's lifetime)
+     */
+    const DoorSettings& settings() const {
+        return _settings;
+    }
+
+    /**
+     * @brief Change one setting and save it
+     * @param name Console name (DoorSettings::Field)
+     */
+    Result set(const char* name, uint32_t value);
+
+    /**
+     * @brief Back to the config.h values and remove the stored record
+     */
+    Result restoreDefaults();
+
+    /**
+     * @brief Called after every change, in the caller's thread, with the field index
+     */
+    void setChangeHandler(Callback<void(int)> handler) {
+        _onChange = handler;
+    }
+
+    Source source() const {
+        return _source;
+    }
+
+    /**
+     * @brief Lowest flash address used by the store (0 if init() failed)
+     */
+    uint32_t regionStart() const {
+        return _store ? _start : 0;
+    }
+
+private:
+    /**
+     * @brief Stored form: header, then the settings as far as the writer knew them
+     */
+    struct Record {
+        uint16_t version;
+        uint16_t size;              // sizeof(DoorSettings) of the firmware that wrote it
+        DoorSettings settings;
+    };
+
+    static const char* const KEY;
+
+    // Built by init() once the region is known (no heap)
+    alignas(FlashIAPBlockDevice) uint8_t _deviceStorage[sizeof(FlashIAPBlockDevice)];
+    alignas(TDBStore) uint8_t _storeStorage[sizeof(TDBStore)];
+    TDBStore* _store;               // nullptr = no usable store
+    uint32_t _start;
+    DoorSettings _settings;
+    Source _source;
+    Callback<void(int)> _onChange;
+
+    void load();
+    bool save();
+};
+
+#endif // RUNTIME_CONFIG_H
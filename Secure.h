@@ -0,0 +1,42 @@
+/**
+ * @file Secure.h
+ * @brief Constant-time comparison and secure wipe helpers
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * Secrets (entered digits, PIN hashes) are compared without an early exit, so
+ * the run time does not tell an attacker how long the matching prefix is, and
+ * wiped through volatile stores the compiler cannot drop as dead writes.
+ */
+
+#ifndef SECURE_H
+#define SECURE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Compare two buffers in time that depends only on the length
+ * @return true if all length bytes are equal
+ */
+inline bool constantTimeEquals(const void* a, const void* b, size_t length) {
+    const uint8_t* pa = static_cast<const uint8_t*>(a);
+    const uint8_t* pb = static_cast<const uint8_t*>(b);
+    volatile uint8_t diff = 0;
+    for (size_t i = 0; i < length; i++) {
+        diff |= pa[i] ^ pb[i];
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief Overwrite a buffer with zeros (not optimised away)
+ */
+inline void secureWipe(void* data, size_t length) {
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+    while (length--) {
+        *p++ = 0;
+    }
+}
+
+#endif // SECURE_H
@@ -0,0 +1,91 @@
+/**
+ * @file SpscRing.h
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ * @author Door Locker Project
+ * @date 2025
+ * 
+ * One context (typically an ISR) pushes, one thread pops. Neither side
+ * blocks or disables interrupts; a full ring drops the new element and
+ * counts it.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class SpscRing
+ * @brief Fixed-size lock-free FIFO for one producer and one consumer
+ * @tparam T Element type (copied in and out)
+ * @tparam N Capacity, must be a power of two
+ */
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+    
+public:
+    SpscRing() : _head(0), _tail(0), _dropped(0) {}
+    
+    /**
+     * @brief Append an element (producer side only)
+     * @param item Element to copy into the ring
+     * @return false if the ring was full and the element was dropped
+     */
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) {
+            _dropped++;
+            return false;
+        }
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Remove the oldest element (consumer side only)
+     * @param item Receives the element
+     * @return false if the ring was empty
+     */
+    bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Check for pending elements (safe from either side)
+     */
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Number of pushes rejected because the ring was full
+     */
+    uint32_t dropped() const {
+        return _dropped;
+    }
+    
+    /**
+     * @brief Ring capacity in elements
+     */
+    static constexpr size_t capacity() {
+        return N;
+    }
+    
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head;    // Next slot to write (producer owned)
+    std::atomic<uint32_t> _tail;    // Next slot to read (consumer owned)
+    volatile uint32_t _dropped;     // Written by the producer only
+};
+
+#endif // SPSC_RING_H
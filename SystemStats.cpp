@@ -0,0 +1,35 @@
+/**
+ * @file SystemStats.cpp
+ * @brief Implementation of the Mbed OS runtime statistics
+ */
+
+#include "SystemStats.h"
+#include "config.h"
+
+void SystemStats::summary(Summary& out) {
+    mbed_stats_cpu_t cpu;
+    mbed_stats_cpu_get(&cpu);
+    out.uptimeMs = (uint32_t)(cpu.uptime / 1000);
+    out.idleMs = (uint32_t)(cpu.idle_time / 1000);
+    out.sleepMs = (uint32_t)(cpu.sleep_time / 1000);
+    out.deepSleepMs = (uint32_t)(cpu.deep_sleep_time / 1000);
+
+    mbed_stats_heap_t heap;
+    mbed_stats_heap_get(&heap);
+    out.heapUsed = heap.current_size;
+    out.heapMax = heap.max_size;
+    out.heapSize = heap.reserved_size;
+    out.heapFailures = heap.alloc_fail_cnt;
+}
+
+int SystemStats::stacks(Stack* out, int max) {
+    mbed_stats_stack_t stacks[STATS_MAX_THREADS];
+    int count = (int)mbed_stats_stack_get_each(stacks, max < STATS_MAX_THREADS ? max : STATS_MAX_THREADS);
+    for (int i = 0; i < count; i++) {
+        const char* name = osThreadGetName(reinterpret_cast<osThreadId_t>(static_cast<uintptr_t>(stacks[i].thread_id)));
+        out[i].name = name ? name : "?";
+        out[i].usedBytes = stacks[i].max_size;
+        out[i].sizeBytes = stacks[i].reserved_size;
+    }
+    return count;
+}
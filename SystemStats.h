@@ -0,0 +1,34 @@
+/**
+ * @file SystemStats.h
+ * @brief Mbed OS runtime statistics for the 'A' pages and telemetry
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Reads mbed_stats_heap_get, mbed_stats_stack_get_each and mbed_stats_cpu_get.
+ * The figures need the platform.*-stats-enabled options in mbed_app.json;
+ * without them Mbed OS reports zeros and no threads. Stack figures are
+ * high-water marks (RTX fills each stack with a watermark pattern), so a
+ * thread's stack can be sized down to its used bytes plus a margin once the
+ * board has been through every path. Percentages are since boot.
+ *
+ * Reading the stacks walks every thread's stack with the kernel locked: a few
+ * hundred microseconds per thread, fine for a key press or a 10 s report.
+ */
+
+#ifndef SYSTEM_STATS_H
+#define SYSTEM_STATS_H
+
+#include "mbed.h"
+#include "DoorIO.h"    // SystemStatsSource
+
+/**
+ * @class SystemStats
+ * @brief Heap, stack and CPU residency figures from Mbed OS
+ */
+class SystemStats : public SystemStatsSource {
+public:
+    void summary(Summary& out) override;
+    int stacks(Stack* out, int max) override;
+};
+
+#endif // SYSTEM_STATS_H
@@ -0,0 +1,96 @@
+/**
+ * @file Telemetry.cpp
+ * @brief Implementation of the binary telemetry stream
+ */
+
+#include "Telemetry.h"
+
+#include <cstring>
+
+using namespace std::chrono;
+
+Telemetry::Telemetry(PinName tx, int baud)
+    : SerialBase(tx, NC, baud), _head(0), _tail(0), _sending(0), _seq(0), _frames(0), _dropped(0) {
+    set_dma_usage_tx(DMA_USAGE_OPPORTUNISTIC);  // DMA where the target's serial port supports it
+    _clock.start();
+}
+
+bool Telemetry::text(const char* message) {
+    size_t length = strlen(message);
+    return emit(TLM_TEXT, message, length < TELEMETRY_MAX_PAYLOAD ? length : TELEMETRY_MAX_PAYLOAD);
+}
+
+bool Telemetry::emit(uint8_t id, const void* payload, size_t length) {
+    if (length > TELEMETRY_MAX_PAYLOAD) {
+        _dropped++;
+        return false;
+    }
+    uint32_t timestamp = (uint32_t)duration_cast<microseconds>(_clock.elapsed_time()).count();
+    uint8_t header[HEADER_SIZE] = {SYNC, (uint8_t)length, id, 0,
+                                   (uint8_t)timestamp, (uint8_t)(timestamp >> 8),
+                                   (uint8_t)(timestamp >> 16), (uint8_t)(timestamp >> 24)};
+    size_t size = HEADER_SIZE + length + CRC_SIZE;
+
+    // Sequence number, CRC and copy together, so frames from other contexts never interleave
+    core_util_critical_section_enter();
+    if (RING_SIZE - (_head - _tail) < size) {
+        _dropped++;
+        core_util_critical_section_exit();
+        return false;
+    }
+    header[3] = _seq++;
+    uint16_t crc = crc16(0xFFFF, header + 1, HEADER_SIZE - 1);
+    crc = crc16(crc, static_cast<const uint8_t*>(payload), length);
+    uint8_t trailer[CRC_SIZE] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+    put(header, HEADER_SIZE);
+    put(payload, length);
+    put(trailer, CRC_SIZE);
+    _frames++;
+    if (_sending == 0) {
+        startTransfer();
+    }
+    core_util_critical_section_exit();
+    return true;
+}
+
+// ==================== RING ====================
+
+void Telemetry::put(const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        _ring[(_head + i) & (RING_SIZE - 1)] = bytes[i];
+    }
+    _head += length;
+}
+
+void Telemetry::startTransfer() {
+    uint32_t start = _tail & (RING_SIZE - 1);
+    uint32_t pending = _head - _tail;
+    _sending = pending < RING_SIZE - start ? pending : RING_SIZE - start;  // Up to the end of the ring
+    SerialBase::write(_ring + start, _sending, callback(this, &Telemetry::onSent), SERIAL_EVENT_TX_COMPLETE);
+}
+
+void Telemetry::onSent(int) {
+    core_util_critical_section_enter();
+    _tail += _sending;
+    _sending = 0;
+    if (_head != _tail) {
+        startTransfer();
+    }
+    core_util_critical_section_exit();
+}
+
+// ==================== CRC ====================
+
+uint16_t Telemetry::crc16(uint16_t crc, const uint8_t* data, size_t length) {
+    // Polynomial 0x1021, one nibble per table lookup
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
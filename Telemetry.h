@@ -0,0 +1,126 @@
+/**
+ * @file Telemetry.h
+ * @brief Binary event frames on a fast UART, sent in the background
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * emit() packs an event into a frame and appends it to a byte ring; the ring
+ * is sent with asynchronous UART writes (one per contiguous run of bytes, by
+ * DMA where the target's serial HAL offers it), so the caller never waits for
+ * the line. A full ring drops the new frame and
+ * counts it. Frames, little-endian:
+ *
+ *   0xA5 | length | id | seq | timestamp (u32 us) | payload | CRC-16 (u16)
+ *
+ * length is the payload size (up to TELEMETRY_MAX_PAYLOAD), seq counts every
+ * frame so the decoder sees drops, and the CRC (CCITT, init 0xFFFF) covers
+ * length to the end of the payload. Event IDs and payload layouts are in
+ * TelemetryEvents.h; tools/telemetry_decode.py turns the stream into text.
+ *
+ * emit() may be called from any thread or ISR. Appending a frame takes a
+ * critical section of a few microseconds (sequence number, CRC and copy of at
+ * most HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + CRC_SIZE bytes); the transfer
+ * runs from the UART interrupt and holds the deep sleep lock only while bytes
+ * are queued.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "mbed.h"
+#include "TelemetryEvents.h"
+#include "config.h"
+
+#if !DEVICE_SERIAL_ASYNCH
+#error "Telemetry needs asynchronous serial (DEVICE_SERIAL_ASYNCH)"
+#endif
+
+/**
+ * @class Telemetry
+ * @brief Framed binary event stream
+ */
+class Telemetry : private SerialBase {
+public:
+    static const uint8_t SYNC = 0xA5;
+    static const size_t HEADER_SIZE = 8;    // Sync, length, id, seq, timestamp
+    static const size_t CRC_SIZE = 2;
+
+    /**
+     * @brief Constructor - transmit only
+     * @param tx UART TX pin
+     * @param baud Line rate
+     */
+    explicit Telemetry(PinName tx, int baud = TELEMETRY_BAUD);
+
+    /**
+     * @brief Queue one event
+     * @param id Event ID (TelemetryEvents.h)
+     * @param payload Packed payload (may be nullptr if length is 0)
+     * @param length Payload bytes, at most TELEMETRY_MAX_PAYLOAD
+     * @return false if the frame was dropped (ring full or payload too long)
+     */
+    bool emit(uint8_t id, const void* payload, size_t length);
+
+    /**
+     * @brief Queue one event with a packed struct payload
+     */
+    template <typename T>
+    bool emit(uint8_t id, const T& payload) {
+        static_assert(sizeof(T) <= TELEMETRY_MAX_PAYLOAD, "Telemetry payload too long");
+        return emit(id, &payload, sizeof(T));
+    }
+
+    /**
+     * @brief Queue a text event (truncated to TELEMETRY_MAX_PAYLOAD)
+     */
+    bool text(const char* message);
+
+    /**
+     * @brief Frames sent or queued since boot
+     */
+    uint32_t frames() const {
+        return _frames;
+    }
+
+    /**
+     * @brief Frames dropped since boot
+     */
+    uint32_t dropped() const {
+        return _dropped;
+    }
+
+private:
+    static const size_t RING_SIZE = TELEMETRY_RING_SIZE;
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "TELEMETRY_RING_SIZE must be a power of two");
+
+    LowPowerTimer _clock;               // Frame timestamps (keeps counting in STOP mode)
+    uint8_t _ring[RING_SIZE];
+    uint32_t _head;                     // Next byte to fill
+    uint32_t _tail;                     // First byte not yet sent
+    uint32_t _sending;                  // Bytes in the running transfer, 0 = idle
+    uint8_t _seq;
+    volatile uint32_t _frames;
+    volatile uint32_t _dropped;
+
+    /**
+     * @brief Send the next contiguous run of the ring (in a critical section)
+     */
+    void startTransfer();
+
+    /**
+     * @brief UART interrupt - a run has gone out
+     */
+    void onSent(int events);
+
+    /**
+     * @brief Append bytes to the ring, wrapping at the end
+     */
+    void put(const void* data, size_t length);
+
+    /**
+     * @brief CRC-16/CCITT update
+     */
+    static uint16_t crc16(uint16_t crc, const uint8_t* data, size_t length);
+};
+
+#endif // TELEMETRY_H
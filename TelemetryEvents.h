@@ -0,0 +1,83 @@
+/**
+ * @file TelemetryEvents.h
+ * @brief Event IDs and payload layouts of the binary telemetry stream
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * The trailing comment of every ID lists its payload fields in order as
+ * name:type, with the Python struct codes B (u8), H (u16), I (u32), i (i32),
+ * c (char) and s (text, the rest of the payload). tools/telemetry_decode.py
+ * reads this file to decode the frames, so keep one ID per line in that form
+ * and payloads packed little-endian (the structs below).
+ */
+
+#ifndef TELEMETRY_EVENTS_H
+#define TELEMETRY_EVENTS_H
+
+#include <cstdint>
+
+enum TelemetryEvent : uint8_t {
+    TLM_TEXT = 0,                // text:s
+    TLM_BOOT = 1,                // lockMs:I keypadMs:I storeMs:I readyMs:I
+    TLM_AUDIT = 2,               // event:B arg:B user:H
+    TLM_LOCK = 3,                // open:B actuationUs:I
+    TLM_COUNTERS = 4,            // framesPresented:I framesSkipped:I ledSteps:I auditDropped:I telemetryDropped:I
+    TLM_BENCH = 5,               // samples:I min:I avg:I max:I name:s
+    TLM_MARK = 6,                // id:H value:I
+    TLM_STATS = 7,               // uptimeMs:I idleMs:I sleepMs:I deepSleepMs:I heapUsed:I heapMax:I heapSize:I
+    TLM_STACK = 8                // thread:B usedBytes:I sizeBytes:I name:s
+};
+
+#pragma pack(push, 1)
+
+struct TlmBoot {
+    uint32_t lockMs;
+    uint32_t keypadMs;
+    uint32_t storeMs;
+    uint32_t readyMs;
+};
+
+struct TlmAudit {
+    uint8_t event;               // AuditSink::Event
+    uint8_t arg;
+    uint16_t user;
+};
+
+struct TlmLock {
+    uint8_t open;
+    uint32_t actuationUs;
+};
+
+struct TlmCounters {
+    uint32_t framesPresented;
+    uint32_t framesSkipped;
+    uint32_t ledSteps;
+    uint32_t auditDropped;
+    uint32_t telemetryDropped;
+};
+
+struct TlmMark {
+    uint16_t id;                 // Caller-defined probe
+    uint32_t value;
+};
+
+struct TlmStats {
+    uint32_t uptimeMs;           // Times since boot: diff two reports for the recent residency
+    uint32_t idleMs;
+    uint32_t sleepMs;
+    uint32_t deepSleepMs;
+    uint32_t heapUsed;
+    uint32_t heapMax;
+    uint32_t heapSize;
+};
+
+struct TlmStack {
+    uint8_t thread;              // Index in this report
+    uint32_t usedBytes;          // High-water mark
+    uint32_t sizeBytes;
+    char name[23];               // Sent up to the NUL
+};
+
+#pragma pack(pop)
+
+#endif // TELEMETRY_EVENTS_H
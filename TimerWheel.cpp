@@ -0,0 +1,135 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief Implementation of the hashed timer wheel
+ */
+
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(Scheduler& base, uint32_t tickMs)
+    : _base(base), _tickMs(tickMs), _free(0), _tick(0), _lastTickMs(0), _tickId(0), _pending(0),
+      _overflows(0) {
+    for (int i = 0; i < TIMER_WHEEL_TIMERS; i++) {
+        _timers[i].task = nullptr;
+        _timers[i].next = i + 1 < TIMER_WHEEL_TIMERS ? i + 1 : NONE;
+        _timers[i].generation = 0;
+    }
+    for (int16_t& slot : _slots) {
+        slot = NONE;
+    }
+}
+
+int TimerWheel::callIn(uint32_t delayMs, Task task, void* context) {
+    return add(delayMs, 0, task, context);
+}
+
+int TimerWheel::callEvery(uint32_t periodMs, Task task, void* context) {
+    return add(periodMs, periodMs, task, context);
+}
+
+// ==================== POOL ====================
+
+int TimerWheel::add(uint32_t delayMs, uint32_t periodMs, Task task, void* context) {
+    if (_free == NONE) {
+        _overflows++;
+        return periodMs ? _base.callEvery(periodMs, task, context) : _base.callIn(delayMs, task, context);
+    }
+
+    // Start the tick with the first timer, so its phase is zero
+    if (_tickId == 0) {
+        _lastTickMs = _base.nowMs();
+        _tickId = _base.callEvery(_tickMs, &TimerWheel::tickTask, this);
+    }
+
+    // Count from the last tick: the part of a tick already gone must not
+    // make the timer early
+    uint32_t phaseMs = _base.nowMs() - _lastTickMs;
+    uint32_t ticks = (delayMs + phaseMs + _tickMs - 1) / _tickMs;
+
+    int16_t index = _free;
+    Timer& timer = _timers[index];
+    _free = timer.next;
+    timer.task = task;
+    timer.context = context;
+    timer.dueTick = _tick + (ticks ? ticks : 1);
+    timer.periodTicks = periodMs ? (periodMs + _tickMs - 1) / _tickMs : 0;
+    link(index);
+    _pending++;
+
+    // Negative ids: index in the low byte, generation above it
+    return -((timer.generation << 8) | (index + 1));
+}
+
+void TimerWheel::cancel(int id) {
+    if (id > 0) {
+        _base.cancel(id);  // Overflowed to the base scheduler
+        return;
+    }
+    int16_t index = (-id & 0xFF) - 1;
+    if (index < 0 || index >= TIMER_WHEEL_TIMERS) {
+        return;
+    }
+    Timer& timer = _timers[index];
+    if (timer.task && (-id >> 8) == timer.generation) {
+        unlink(index);
+        release(index);
+    }
+}
+
+void TimerWheel::release(int16_t index) {
+    Timer& timer = _timers[index];
+    timer.task = nullptr;
+    timer.generation = (timer.generation + 1) & 0x7FFF;  // Keeps the id positive before negation
+    timer.next = _free;
+    _free = index;
+
+    // Nothing left to time - stop waking the base scheduler
+    if (--_pending == 0) {
+        _base.cancel(_tickId);
+        _tickId = 0;
+    }
+}
+
+// ==================== SLOTS ====================
+
+void TimerWheel::link(int16_t index) {
+    int16_t& head = _slots[_timers[index].dueTick & (TIMER_WHEEL_SLOTS - 1)];
+    _timers[index].next = head;
+    head = index;
+}
+
+void TimerWheel::unlink(int16_t index) {
+    int16_t* link = &_slots[_timers[index].dueTick & (TIMER_WHEEL_SLOTS - 1)];
+    while (*link != index) {
+        link = &_timers[*link].next;
+    }
+    *link = _timers[index].next;
+}
+
+void TimerWheel::onTick() {
+    _tick++;
+    _lastTickMs = _base.nowMs();
+
+    // One timer at a time: a task may add or cancel timers in this very slot
+    int16_t& head = _slots[_tick & (TIMER_WHEEL_SLOTS - 1)];
+    while (true) {
+        int16_t index = head;
+        while (index != NONE && _timers[index].dueTick != _tick) {
+            index = _timers[index].next;  // Due on a later turn of the wheel
+        }
+        if (index == NONE) {
+            break;
+        }
+
+        Timer& timer = _timers[index];
+        Task task = timer.task;
+        void* context = timer.context;
+        unlink(index);
+        if (timer.periodTicks) {
+            timer.dueTick += timer.periodTicks;
+            link(index);
+        } else {
+            release(index);
+        }
+        task(context);
+    }
+}
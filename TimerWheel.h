@@ -0,0 +1,103 @@
+/**
+ * @file TimerWheel.h
+ * @brief Many timers multiplexed onto one periodic tick of another scheduler
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * With several doors on one board every DoorController keeps up to five
+ * deadlines pending (message timeout, auto-close, lockout end, countdown,
+ * backlight). The wheel keeps them in a fixed pool hashed into
+ * TIMER_WHEEL_SLOTS buckets by due tick, so adding, cancelling and expiring a
+ * timer costs the same however many are pending, and the base scheduler only
+ * ever sees one periodic task. The tick runs only while a timer is pending.
+ *
+ * Deadlines are rounded up to the next tick: a timer never fires early and at
+ * most TIMER_WHEEL_TICK_MS late. Should the pool run out, the timer goes to the
+ * base scheduler instead, so no deadline is ever lost (wheel ids are negative,
+ * base ids positive).
+ *
+ * Hardware-free: on the board the base is the EventQueue scheduler, on the host
+ * the simulated clock of tests/test_door_sim.cpp.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "DoorIO.h"    // Scheduler
+#include "config.h"
+
+#include <cstdint>
+
+static_assert((TIMER_WHEEL_SLOTS & (TIMER_WHEEL_SLOTS - 1)) == 0, "TIMER_WHEEL_SLOTS must be a power of two");
+static_assert(TIMER_WHEEL_TIMERS > 0 && TIMER_WHEEL_TIMERS < 256, "TIMER_WHEEL_TIMERS must be 1..255");
+
+/**
+ * @class TimerWheel
+ * @brief Hashed timer wheel running on top of a base Scheduler
+ */
+class TimerWheel : public Scheduler {
+public:
+    /**
+     * @brief Constructor
+     * @param base Scheduler that provides the clock and runs the tick
+     * @param tickMs Tick period, the resolution of every timer
+     */
+    explicit TimerWheel(Scheduler& base, uint32_t tickMs = TIMER_WHEEL_TICK_MS);
+
+    uint32_t nowMs() override {
+        return _base.nowMs();
+    }
+
+    int callIn(uint32_t delayMs, Task task, void* context) override;
+    int callEvery(uint32_t periodMs, Task task, void* context) override;
+    void cancel(int id) override;
+
+    /**
+     * @brief Timers pending in the wheel (not counting any handed to the base)
+     */
+    int pending() const {
+        return _pending;
+    }
+
+    /**
+     * @brief Timers that did not fit in the pool and went to the base scheduler
+     */
+    uint32_t overflows() const {
+        return _overflows;
+    }
+
+private:
+    static const int16_t NONE = -1;
+
+    struct Timer {
+        Task task;              // nullptr = free
+        void* context;
+        uint32_t dueTick;       // Absolute tick the timer fires on
+        uint32_t periodTicks;   // 0 = one-shot
+        int16_t next;           // Next timer in the same slot, or in the free list
+        uint16_t generation;    // Bumped on every reuse, so stale ids do not match
+    };
+
+    Scheduler& _base;
+    const uint32_t _tickMs;
+    Timer _timers[TIMER_WHEEL_TIMERS];
+    int16_t _slots[TIMER_WHEEL_SLOTS];  // Head of each bucket (dueTick % SLOTS)
+    int16_t _free;                      // Head of the free list
+    uint32_t _tick;                     // Ticks run so far
+    uint32_t _lastTickMs;               // Base clock at the latest tick
+    int _tickId;                        // Base task running onTick(), 0 = stopped
+    int _pending;
+    uint32_t _overflows;
+
+    int add(uint32_t delayMs, uint32_t periodMs, Task task, void* context);
+    void link(int16_t index);
+    void unlink(int16_t index);
+    void release(int16_t index);
+    void onTick();
+
+    static void tickTask(void* self) {
+        static_cast<TimerWheel*>(self)->onTick();
+    }
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,180 @@
+/**
+ * @file TinyFormat.cpp
+ * @brief Implementation of the printf subset
+ */
+
+#include "TinyFormat.h"
+
+// ==================== CONVERSIONS ====================
+
+/**
+ * @brief Digits of a value, written backwards from the end of a buffer
+ * @return First digit
+ */
+static char* toDigits(char* end, unsigned long value, unsigned base, bool upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[value % base];
+        value /= base;
+    } while (value);
+    return end;
+}
+
+// ==================== FORMATTER ====================
+
+int tinyVFormat(TinyPut put, void* context, const char* format, va_list args) {
+    int count = 0;
+
+    while (char c = *format++) {
+        if (c != '%') {
+            put(context, c);
+            count++;
+            continue;
+        }
+        const char* start = format - 1;  // Echoed if the conversion is unsupported
+
+        // Flags, width, precision, length
+        bool left = false;
+        bool zero = false;
+        for (;; format++) {
+            if (*format == '-') {
+                left = true;
+            } else if (*format == '0') {
+                zero = true;
+            } else {
+                break;
+            }
+        }
+        int width = 0;
+        while (*format >= '0' && *format <= '9') {
+            width = width * 10 + (*format++ - '0');
+        }
+        int precision = -1;
+        if (*format == '.') {
+            format++;
+            precision = 0;
+            while (*format >= '0' && *format <= '9') {
+                precision = precision * 10 + (*format++ - '0');
+            }
+        }
+        bool isLong = false;
+        if (*format == 'l') {
+            isLong = true;
+            format++;
+        }
+
+        // Conversion into text/length (digits are built in number[])
+        char number[3 * sizeof(unsigned long) + 1];
+        char* digitsEnd = number + sizeof(number);
+        const char* text = digitsEnd;
+        const char* end = digitsEnd;
+        char sign = 0;
+
+        switch (*format) {
+            case 'd':
+            case 'i': {
+                long value = isLong ? va_arg(args, long) : va_arg(args, int);
+                unsigned long magnitude = value < 0 ? 0ul - (unsigned long)value : (unsigned long)value;
+                sign = value < 0 ? '-' : 0;
+                text = toDigits(digitsEnd, magnitude, 10, false);
+                break;
+            }
+            case 'u':
+                text = toDigits(digitsEnd, isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned), 10, false);
+                break;
+            case 'x':
+            case 'X':
+                text = toDigits(digitsEnd, isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned), 16,
+                                *format == 'X');
+                break;
+            case 'c':
+                number[0] = (char)va_arg(args, int);
+                text = number;
+                end = number + 1;
+                break;
+            case 's':
+                text = va_arg(args, const char*);
+                if (!text) {
+                    text = "(null)";
+                }
+                for (end = text; *end && (precision < 0 || end - text < precision); end++) {
+                }
+                zero = false;
+                break;
+            case '%':
+                number[0] = '%';
+                text = number;
+                end = number + 1;
+                width = 0;
+                break;
+            default:
+                // Unsupported - copy the specification through unchanged
+                text = start;
+                end = format + (*format ? 1 : 0);
+                width = 0;
+                break;
+        }
+        if (*format) {
+            format++;
+        }
+        int length = end - text;
+
+        // Padding: spaces (right-aligned), sign, zeros, text, spaces (left-aligned)
+        int pad = width - length - (sign ? 1 : 0);
+        if (!left && !zero) {
+            for (; pad > 0; pad--, count++) {
+                put(context, ' ');
+            }
+        }
+        if (sign) {
+            put(context, sign);
+            count++;
+        }
+        if (!left && zero) {
+            for (; pad > 0; pad--, count++) {
+                put(context, '0');
+            }
+        }
+        for (int i = 0; i < length; i++) {
+            put(context, text[i]);
+        }
+        count += length;
+        for (; pad > 0; pad--, count++) {
+            put(context, ' ');
+        }
+    }
+    return count;
+}
+
+// ==================== STRING OUTPUT ====================
+
+struct StringOut {
+    char* out;
+    size_t size;
+    size_t used;
+};
+
+static void putString(void* context, char c) {
+    StringOut& s = *static_cast<StringOut*>(context);
+    if (s.used + 1 < s.size) {
+        s.out[s.used] = c;
+    }
+    s.used++;
+}
+
+int tinyVsnprintf(char* out, size_t size, const char* format, va_list args) {
+    StringOut s = {out, size, 0};
+    int count = tinyVFormat(&putString, &s, format, args);
+    if (size > 0) {
+        out[s.used < size ? s.used : size - 1] = '\0';
+    }
+    return count;
+}
+
+int tinySnprintf(char* out, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int count = tinyVsnprintf(out, size, format, args);
+    va_end(args);
+    return count;
+}
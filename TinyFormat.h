@@ -0,0 +1,82 @@
+/**
+ * @file TinyFormat.h
+ * @brief Small, non-allocating printf subset for the LCD and serial paths
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Characters go straight to a put function (an LCD frame cell, a short serial
+ * chunk), so there is no intermediate line buffer and newlib's printf, with its
+ * floating point and locale support, is never linked for these paths.
+ *
+ * Supported: %d %i %u %x %X %c %s %%, the 'l' length modifier, the '-' and '0'
+ * flags, a field width and a %s precision (%.16s). Anything else is copied to
+ * the output as written, flagging the mistake on the screen or console. Callers
+ * are declared with TINY_FORMAT_CHECK, so GCC checks the arguments against the
+ * format string at compile time.
+ */
+
+#ifndef TINY_FORMAT_H
+#define TINY_FORMAT_H
+
+#include <cstdarg>
+#include <cstddef>
+
+#if defined(__GNUC__)
+#define TINY_FORMAT_CHECK(formatIndex, firstArg) __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#define TINY_FORMAT_CHECK(formatIndex, firstArg)
+#endif
+
+/**
+ * @brief Receives one output character
+ */
+typedef void (*TinyPut)(void* context, char c);
+
+/**
+ * @brief Format into a put function
+ * @return Number of characters produced
+ */
+int tinyVFormat(TinyPut put, void* context, const char* format, va_list args);
+
+/**
+ * @brief snprintf() replacement (always NUL-terminates when size > 0)
+ * @return Length the full result would have, like snprintf()
+ */
+int tinySnprintf(char* out, size_t size, const char* format, ...) TINY_FORMAT_CHECK(3, 4);
+
+/**
+ * @brief vsnprintf() replacement
+ */
+int tinyVsnprintf(char* out, size_t size, const char* format, va_list args);
+
+/**
+ * @brief Format to anything with write(const void*, size_t), e.g. BufferedSerial
+ * Output is handed over in ChunkSize pieces from a small stack buffer.
+ * @return Number of characters produced
+ */
+template <typename Writer, size_t ChunkSize = 32>
+int tinyVWrite(Writer& writer, const char* format, va_list args) {
+    struct Chunk {
+        Writer& writer;
+        size_t used;
+        char data[ChunkSize];
+
+        static void put(void* context, char c) {
+            Chunk& chunk = *static_cast<Chunk*>(context);
+            chunk.data[chunk.used++] = c;
+            if (chunk.used == ChunkSize) {
+                chunk.writer.write(chunk.data, chunk.used);
+                chunk.used = 0;
+            }
+        }
+    };
+
+    Chunk chunk = {writer, 0, {}};
+    int count = tinyVFormat(&Chunk::put, &chunk, format, args);
+    if (chunk.used) {
+        writer.write(chunk.data, chunk.used);
+    }
+    return count;
+}
+
+#endif // TINY_FORMAT_H
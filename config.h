@@ -2,23 +2,107 @@
 #define CONFIG_H
 
 // ==================== PASSWORD SETTINGS ====================
-#define PASSWORD "1234"              // Default password (4 digits)
+#define PASSWORD "1234"              // Admin PIN written to a fresh PIN store
 #define MAX_PASSWORD_LENGTH 8        // Maximum password length
 
 // ================ KEYPAD SETTINGS =======================
 #define ROWS 4                      // Number of rows in keypad
 #define COLS 4                      // Number of columns in keypad
+#define KEYPAD_SCAN_PERIOD_MS (DEBOUNCE_TIME_MS / 4)  // Debouncer needs 4 stable scans
+#define KEYPAD_EVENT_QUEUE_SIZE 16  // Buffered key events (power of two)
+#define INPUT_MAIL_SIZE 32          // Key events waiting for the door thread, per keypad
+#define INPUT_THREAD_STACK_SIZE 768 // Bytes; input thread stack
+
+// ================ LCD SETTINGS ==========================
+#define LCD_COLUMNS 16              // Characters per line
+#define LCD_LINES 2                 // Number of lines
+#define LCD_I2C_ADDRESS 0x27        // 7-bit backpack address (0x3F for PCF8574A)
+#define LCD_I2C_FREQUENCY_HZ 100000 // Most backpacks also run at 400000 (Fast-mode)
+#define LCD_I2C_TIMEOUT_MS 50       // Give up on a burst the display never finishes
+#define COUNTDOWN_BAR_CELLS (LCD_COLUMNS - 6)  // Countdown bar after the icon and seconds, 5 steps a cell
+#define COUNTDOWN_MIN_STEP_MS 100   // Fastest countdown refresh (short periods skip bar steps)
+#define DISPLAY_THREAD_STACK_SIZE 1024  // Bytes; UI thread stack
 
 // ==================== TIMING SETTINGS ====================
-#define OPEN_TIME_MS 10000           // Door open duration (milliseconds)
+#define OPEN_TIME_MS 10000           // Door open duration (default of the stored setting open_ms)
 #define LED_FLASH_PERIOD_MS 500      // LED flash period (500ms = 2Hz)
-#define LOCKOUT_TIME_MS 30000        // Lockout duration (30 seconds)
-#define DEBOUNCE_TIME_MS 50          // Keypad debounce delay
+#define LOCKOUT_TIME_MS 30000        // Lockout duration (default of lockout_ms)
+#define DEBOUNCE_TIME_MS 20          // Keypad debounce window (default of debounce_ms)
+#define BACKLIGHT_TIMEOUT_MS 15000   // Idle time before the LCD backlight goes off
+#define BOOT_SPLASH_MS 1000          // Version screen at boot, 0 = straight to the prompt (a key skips it)
+
+// ==================== STATUS LED SETTINGS ====================
+#define STATUS_LED_PWM true          // LED on a timer channel: brightness, hardware blinking (false = GPIO only)
+#define LED_PWM_PERIOD_US 1000       // PWM carrier for dimmed levels (1kHz, no visible flicker)
+#define LED_RAMP_STEP_MS 20          // Brightness update interval while a pattern ramps
+
+// ==================== LOCK ACTUATOR SETTINGS ====================
+#define RELAY_PULL_IN_MS 100         // Full coil voltage until the armature has pulled in
+#define RELAY_HOLD_PERCENT 40        // Coil PWM duty while held open (100 = no hold PWM)
+#define RELAY_PWM_PERIOD_US 50       // Hold PWM period (20kHz, inaudible; needs a transistor-driven module)
+#define RELAY_STAGGER_PULL_IN true   // Relays opening together pull in one after another
+#define SERVO_CLOSED_US 1000         // Servo pulse at the locked position (0 degrees)
+#define SERVO_OPEN_US 2000           // Servo pulse at the open position (90 degrees)
+#define SERVO_TRAVEL_MS 400          // Eased full-travel move, in 20ms servo frames
+#define SERVO_SETTLE_MS 200          // Hold after the move before the servo PWM is suspended
 
 // ==================== SECURITY SETTINGS ====================
-#define MAX_FAILED_ATTEMPTS 3        // Max wrong attempts before lockout
+#define MAX_FAILED_ATTEMPTS 3        // Max wrong attempts before lockout (default of attempts)
+
+// ==================== PIN STORE SETTINGS ====================
+#define PIN_STORE_CAPACITY 4096      // Hash table slots (power of two, 96 KB flash per bank, ~2500 users)
+#define PIN_STORE_BUCKET_SLOTS 8     // Slots per bucket; a lookup reads two buckets
+#define PIN_SALT_SIZE 16             // Bytes of per-unit salt
+#define PIN_KDF_BUDGET_MS 50         // Time for one PIN hash, calibrated when the store is formatted
+#define PIN_KDF_ITERATIONS 0         // 0 = calibrate to PIN_KDF_BUDGET_MS, else fixed SHA-256 rounds
+#define PIN_KDF_MIN_ITERATIONS 100   // Floor for the calibrated count
+#define ADMIN_USER_ID 0              // Gets PASSWORD on first boot; may use the console
+#define AUDIT_LOG_SECTORS 16         // Flash sectors below the PIN store (~2000 entries)
+#define AUDIT_LOG_STAGING 32         // Entries buffered in RAM between flushes
+#define AUDIT_LOG_BATCH 8            // Staged entries that trigger an immediate flush
+#define AUDIT_LOG_FLUSH_MS 2000      // Longest time an entry stays in RAM
+#define AUDIT_CLOCK_MIN_EPOCH 1735689600  // 2025-01-01; earlier entry times are from an RTC never set
+#define CONFIG_STORE_SIZE 16384      // KVStore (TDBStore) bytes below the audit log, for the door settings
+#define MAINTENANCE_CONSOLE true     // PIN management over USB serial (UART keeps the core out of STOP)
+#define CONSOLE_SESSION_TIMEOUT_MS 300000  // Idle admin session closed before the next command
+
+// ==================== MULTI-DOOR SETTINGS ====================
+#define DOOR_CHANNELS 1              // Doors on this board; > 1 builds main_multidoor.cpp (relays only)
+#define KEYPAD_SCANNER_MAX 8         // Keypads one KeypadScanner can time-slice
+#define DISPLAY_MAX_SCREENS 8        // LCDs one DisplayThread can drive on the shared I2C bus
+#define INPUT_MAX_CHANNELS 8         // Keypads one InputThread serves
+#define TIMER_WHEEL_TICK_MS 10       // Resolution of the shared door deadlines
+#define TIMER_WHEEL_SLOTS 64         // Wheel buckets (power of two)
+#define TIMER_WHEEL_TIMERS 48        // Timer pool, five per door plus spares for 8 doors
+
+// ==================== STATS SETTINGS ====================
+#define STATS_MAX_THREADS 8          // Thread stacks listed on the 'A' pages and in telemetry
+#define STATS_PAGE_MS 3000           // Time each 'A' diagnostics page stays up
+
+// ==================== DEADLINE SETTINGS ====================
+#define WATCHDOG_ENABLED true        // Hardware watchdog, fed only while every task meets its deadline
+#define WATCHDOG_TIMEOUT_MS 8000     // Reset after this long without a feed (the IWDG keeps running in STOP)
+#define DEADLINE_CHECK_MS 1000       // Heartbeat that checks the deadlines and feeds the watchdog
+#define DEADLINE_TIMER_MS 100        // Allowed lateness of door timers (auto-close, lockout end, countdown)
+#define DEADLINE_KEY_MS 150          // Key event to handling (a PIN check alone takes PIN_KDF_BUDGET_MS)
+#define DEADLINE_UI_MS 500           // Frame submitted to drawn on the LCD
+#define DEADLINE_TASKS 4             // Declared tasks: timers, keys, UI, one spare
+#define DEADLINE_SLOTS 8             // Timers measured at once (more run unmeasured)
+
+// ==================== TELEMETRY SETTINGS ====================
+#define TELEMETRY false              // Binary event frames on USART1 TX (PA_9), decoded by tools/telemetry_decode.py
+#define TELEMETRY_BAUD 921600        // Line rate of the telemetry UART
+#define TELEMETRY_RING_SIZE 1024     // TX ring bytes (power of two); a full ring drops frames
+#define TELEMETRY_MAX_PAYLOAD 32     // Largest event payload in bytes
+#define TELEMETRY_COUNTERS_MS 1000   // Counter snapshot period, 0 = none (the snapshot wakes the core from STOP)
+#define TELEMETRY_STATS_MS 10000     // Heap, stack and CPU report period, 0 = none
+
+// ==================== DEBUG SETTINGS ====================
+#define ENABLE_PROFILING false       // DWT cycle probes (PROFILE_SCOPE) on hot paths
+#define PROFILE_REPORT_PERIOD_MS 0   // Periodic report on the console, 0 = on demand only
+#define LONG_PRESS_MS 1000           // Holding 'A' this long prints the profile report
 
 // ==================== HARDWARE SETTINGS ====================
-#define USE_RELAY true               // true = relay, false = servo
+#define USE_RELAY true               // true = relay, false = servo (default of relay)
 
 #endif
\ No newline at end of file
@@ -7,363 +7,318 @@
  * Features:
  * - 4x4 Matrix keypad for password entry
  * - 16x2 LCD display for user feedback
- * - LED indicator (ON when closed, FLASHING when open)
+ * - Status LED patterns (solid closed, flashing open, double blink in lockout)
  * - Password masking for security
  * - Failed attempt counter with lockout
  * - 10-second auto-close timer
+ * - Relay pull-in then PWM hold, or eased servo moves
+ * - Optional binary telemetry stream (TELEMETRY)
+ * - Task deadline tracking, watchdog fed only while every deadline is met
+ * - Memory and CPU statistics on the 'A' pages and in the telemetry
+ * - Door timings, attempt limit, debounce and lock type stored in flash, changed live
+ * - Input, door and display threads by priority, linked by preallocated mailboxes
+ * 
+ * Single-door board; with DOOR_CHANNELS > 1 main_multidoor.cpp is built instead.
  */
 
-#ifndef BUILD_TESTS
+#include "config.h"
+
+#if !defined(BUILD_TESTS) && DOOR_CHANNELS == 1
 
 #include <mbed.h>
-#include "TextLCD.h"
+#include <cstring>
+#include "PCF8574LCD.h"
 #include "Keypad.h"
-#include "config.h"  
+#include "DisplayThread.h"
+#include "DoorController.h"
+#include "InputThread.h"
+#include "LedEngine.h"
+#include "LockDriver.h"
+#include "QueueScheduler.h"
+#include "DeadlineScheduler.h"
+#include "PinStore.h"
+#include "MaintenanceConsole.h"
+#include "AuditLog.h"
+#include "Profiler.h"
+#include "BootTimes.h"
+#include "SystemStats.h"
+#include "RuntimeConfig.h"
+#if TELEMETRY
+#include "Telemetry.h"
+#endif
 
 // ==================== HARDWARE I/O ====================
 // I2C LCD Display (16x2)
 I2C i2c(PB_7, PB_6);                 // SDA, SCL pins
-TextLCD_I2C lcd(&i2c, 0x27, TextLCD::LCD16x2);
+PCF8574LCD lcd(i2c, LCD_I2C_ADDRESS);
+DisplayScreen screen(lcd);           // Latest-frame mailbox for the LCD
+DisplayThread display;               // UI thread, sole user of the I2C bus
 
-// LED Indicator (built-in LED on most Nucleo boards)
-DigitalOut led(PC_13);
+// Status LED on a timer channel (TIM4_CH3): patterns and brightness in hardware
+LedEngine statusLed(PB_8);
 
-// Lock Control (Relay or Servo)
-#if USE_RELAY
-    DigitalOut lockControl(PA_8);    // Relay control pin
-#else
-    PwmOut lockControl(PA_8);        // Servo control pin (PWM)
-#endif
+// Lock Control (Relay or Servo) on a timer channel (TIM1_CH1): pull-in/hold or profiled moves
+LockDriver lockDriver(PA_8, USE_RELAY ? LockDriver::MODE_RELAY : LockDriver::MODE_SERVO);
 
 // Keypad Configuration (4x4 Matrix)
-PinName rowPins[ROWS] = {PA_0, PA_1, PA_4, PA_5};  // Row pins
-PinName colPins[COLS] = {PB_0, PB_1, PB_3, PB_4};  // Column pins
+const PinName rowPins[ROWS] = {PA_0, PA_1, PA_4, PA_5};  // Row pins
+const PinName colPins[COLS] = {PB_0, PB_1, PB_3, PB_4};  // Column pins
 
 // Keypad layout mapping
-char keys[ROWS][COLS] = {
+constexpr char keys[ROWS][COLS] = {
     {'1','2','3','A'},
     {'4','5','6','B'},
     {'7','8','9','C'},
     {'*','0','#','D'}
 };
 
-Keypad keypad(keys, rowPins, colPins, ROWS, COLS);
+Keypad<ROWS, COLS> keypad(keys, rowPins, colPins);
+InputThread input;                   // Input thread, above the door thread
+InputChannel keyInput(keypad);       // Keypad events in Mail for the door thread
+
+// User PINs (salted hashes in internal flash)
+PinStore pinStore;
+AuditLog auditLog;                   // Grants, failures, lockouts, admin keys
+#if MAINTENANCE_CONSOLE
+    MaintenanceConsole console(pinStore, auditLog, USBTX, USBRX);
+#endif
+SystemStats systemStats;             // Heap, stack and CPU figures ('A' pages, telemetry)
+RuntimeConfig runtimeConfig;         // Door settings from flash (console 'config')
 
-// ==================== GLOBAL VARIABLES ====================
-std::string inputPassword = "";      // User input buffer
-int failedAttempts = 0;              // Failed login counter
-bool isDoorOpen = false;             // Door state flag
-bool isLockedOut = false;            // Lockout state flag
+#if TELEMETRY
+// ==================== TELEMETRY ====================
+Telemetry telemetry(PA_9);           // USART1 TX: binary frames for tools/telemetry_decode.py
 
-// Timers
-Timer doorTimer;                     // Timer for auto-close
-Timer lockoutTimer;                  // Timer for lockout period
-Ticker ledTicker;                    // Ticker for LED flashing
+/**
+ * @brief Door events go to the flash log and the telemetry stream
+ */
+class TelemetryAudit : public AuditSink {
+public:
+    void record(Event event, uint8_t arg, uint16_t userId) override {
+        auditLog.record(event, arg, userId);
+        TlmAudit payload = {event, arg, userId};
+        telemetry.emit(TLM_AUDIT, payload);
+    }
+};
+TelemetryAudit doorAudit;
+
+/**
+ * @brief Lock in position (ISR context)
+ */
+void onLockMoved() {
+    TlmLock payload = {lockDriver.isOpen(), lockDriver.lastActuationUs()};
+    telemetry.emit(TLM_LOCK, payload);
+}
 
-// ==================== FUNCTION PROTOTYPES ====================
-void openLock();
-void closeLock();
-void checkPassword();
-void ledFlashISR();
-void updateLCD();
-void resetSystem();
-void handleSpecialKeys(char key);
+/**
+ * @brief Periodic snapshot of the instrumentation counters
+ */
+void emitCounters() {
+    TlmCounters payload = {screen.framesPresented(), screen.framesSkipped(), statusLed.stepInterrupts(),
+                           auditLog.dropped(), telemetry.dropped()};
+    telemetry.emit(TLM_COUNTERS, payload);
+}
 
-// ==================== LED FLASHING ISR ====================
 /**
- * @brief Interrupt Service Routine for LED flashing
- * Called by Ticker every LED_FLASH_PERIOD_MS/2 milliseconds
+ * @brief Periodic heap, CPU and per-thread stack report
  */
-void ledFlashISR() {
-    if (isDoorOpen) {
-        led = !led;  // Toggle LED state
+void emitStats() {
+    SystemStatsSource::Summary stats;
+    systemStats.summary(stats);
+    TlmStats payload = {stats.uptimeMs, stats.idleMs, stats.sleepMs, stats.deepSleepMs,
+                        stats.heapUsed, stats.heapMax, stats.heapSize};
+    telemetry.emit(TLM_STATS, payload);
+
+    SystemStatsSource::Stack stacks[STATS_MAX_THREADS];
+    int count = systemStats.stacks(stacks, STATS_MAX_THREADS);
+    for (int i = 0; i < count; i++) {
+        TlmStack stack = {(uint8_t)i, stacks[i].usedBytes, stacks[i].sizeBytes, {}};
+        strncpy(stack.name, stacks[i].name, sizeof(stack.name));
+        size_t nameLength = strnlen(stack.name, sizeof(stack.name));
+        telemetry.emit(TLM_STACK, &stack, sizeof(stack) - sizeof(stack.name) + nameLength);
     }
 }
+#else
+AuditSink& doorAudit = auditLog;
+#endif
+
+// ==================== EVENT LOOP ====================
+// Every door handler runs on this queue (the main thread), none of them sleeps
+EventQueue queue(32 * EVENTS_EVENT_SIZE);
+volatile bool keyDrainPending = false;  // drainKeypad() already posted
+volatile uint32_t keyPostedMs = 0;   // When the pending drain was posted
+
+QueueScheduler scheduler(queue);     // Door deadlines on the event queue
+DeadlineScheduler deadlines(scheduler);  // ... with their lateness measured
+DoorController door(keyInput, screen, lockDriver, deadlines, doorAudit);
+int keyTask = -1;                    // Declared deadline tasks (besides the door timers)
+int uiTask = -1;
+BootTimes bootTimes = {};
 
-// ==================== LOCK CONTROL FUNCTIONS ====================
+// ==================== BOOT STAGES ====================
 /**
- * @brief Opens the door lock and starts LED flashing
+ * @brief UI thread: the LCD finished its initialisation
  */
-void openLock() {
-    isDoorOpen = true;
-    
-    #if USE_RELAY
-        lockControl = 1;             // Energize relay (lock opens)
-    #else
-        lockControl.period_ms(20);   // 50Hz for servo
-        lockControl.pulsewidth_ms(2);// 2ms pulse = 90 degrees
-    #endif
-    
-    // Start LED flashing at 2Hz (toggle every 250ms)
-    ledTicker.attach(&ledFlashISR, 250ms);
-    
-    // Start door timer
-    doorTimer.reset();
-    doorTimer.start();
+void markDisplayReady() {
+    bootTimes.displayMs = scheduler.nowMs();
 }
 
+// ==================== KEYPAD EVENTS ====================
 /**
- * @brief Closes the door lock and turns LED solid ON
+ * @brief Send the profiler report to the maintenance console
  */
-void closeLock() {
-    isDoorOpen = false;
-    
-    #if USE_RELAY
-        lockControl = 0;             // De-energize relay (lock closes)
-    #else
-        lockControl.period_ms(20);
-        lockControl.pulsewidth_ms(1);// 1ms pulse = 0 degrees
-    #endif
-    
-    // Stop LED flashing and turn it ON solid
-    ledTicker.detach();
-    led = 1;  // LED ON when door is closed
-    
-    doorTimer.stop();
+void printProfile() {
+#if MAINTENANCE_CONSOLE
+    console.printProfile();
+#endif
 }
 
-// ==================== PASSWORD VALIDATION ====================
 /**
- * @brief Validates entered password and controls access
+ * @brief Handle every key event queued since the last call (runs on the queue)
  */
-void checkPassword() {
-    // Check if system is locked out
-    if (isLockedOut) {
-        lcd.cls();
-        lcd.printf("LOCKED OUT!");
-        lcd.locate(0, 1);
-        int remaining = (LOCKOUT_TIME_MS - lockoutTimer.read_ms()) / 1000;
-        lcd.printf("Wait %ds", remaining);
-        return;
-    }
-    
-    // Validate password
-    if (inputPassword == PASSWORD) {
-        // CORRECT PASSWORD
-        lcd.cls();
-        lcd.printf("Access Granted!");
-        lcd.locate(0, 1);
-        lcd.printf("Door Opening...");
-        
-        failedAttempts = 0;  // Reset failed attempts
-        openLock();
-        
-    } else {
-        // WRONG PASSWORD
-        failedAttempts++;
-        lcd.cls();
-        lcd.printf("Wrong Password!");
-        lcd.locate(0, 1);
-        lcd.printf("Attempts: %d/%d", failedAttempts, MAX_FAILED_ATTEMPTS);
-        
-        // Check if max attempts reached
-        if (failedAttempts >= MAX_FAILED_ATTEMPTS) {
-            ThisThread::sleep_for(2000);
-            lcd.cls();
-            lcd.printf("TOO MANY TRIES!");
-            lcd.locate(0, 1);
-            lcd.printf("Locked 30s");
-            
-            isLockedOut = true;
-            lockoutTimer.reset();
-            lockoutTimer.start();
-        }
-    }
-    
-    // Clear input buffer
-    inputPassword.clear();
-    ThisThread::sleep_for(2000);
-    updateLCD();
+void drainKeypad() {
+    // Keys pressed during the boot only count from the moment the door was ready
+    uint32_t postedMs = keyPostedMs;
+    keyDrainPending = false;
+    uint32_t since = static_cast<int32_t>(postedMs - bootTimes.readyMs) > 0 ? postedMs : bootTimes.readyMs;
+    deadlines.record(keyTask, scheduler.nowMs() - since);
+    door.processKeys();
 }
 
-// ==================== LCD UPDATE ====================
 /**
- * @brief Updates LCD display based on system state
+ * @brief Input thread: new events in the mailbox - posts one drain to the queue
  */
-void updateLCD() {
-    lcd.cls();
-    
-    if (isLockedOut) {
-        lcd.printf("LOCKED OUT!");
-        lcd.locate(0, 1);
-        int remaining = (LOCKOUT_TIME_MS - lockoutTimer.read_ms()) / 1000;
-        lcd.printf("Wait %ds", remaining);
-    } else if (isDoorOpen) {
-        lcd.printf("Door Open");
-        lcd.locate(0, 1);
-        int remaining = (OPEN_TIME_MS - doorTimer.read_ms()) / 1000;
-        lcd.printf("Closing in %ds", remaining);
-    } else {
-        lcd.printf("Enter Password:");
-        lcd.locate(0, 1);
-        // Display masked password (asterisks)
-        for (size_t i = 0; i < inputPassword.length(); i++) {
-            lcd.printf("*");
-        }
+void onKeyEvent() {
+    if (!keyDrainPending) {
+        keyDrainPending = true;
+        keyPostedMs = scheduler.nowMs();
+        queue.call(drainKeypad);
     }
 }
 
-// ==================== SYSTEM RESET ====================
+// ==================== RUNTIME CONFIG ====================
 /**
- * @brief Resets system after lockout period
+ * @brief A setting changed on the console (console thread)
+ * The door reads its timings at every use and the keypad takes the debounce
+ * time from its next scan session; the lock type waits for the next boot.
  */
-void resetSystem() {
-    isLockedOut = false;
-    failedAttempts = 0;
-    inputPassword.clear();
-    lockoutTimer.stop();
-    updateLCD();
+void onConfigChanged(int) {
+    keypad.setDebounceTime(runtimeConfig.settings().debounceTimeMs);
 }
 
-// ==================== SPECIAL KEY HANDLER ====================
+// ==================== DEADLINES ====================
 /**
- * @brief Handles special keys A, B, C, D with custom functionality
- * @param key The special key pressed ('A', 'B', 'C', 'D')
+ * @brief Heartbeat: feed the watchdog only if every task kept its deadline
+ * A missed deadline skips the feed; misses for WATCHDOG_TIMEOUT_MS reset the
+ * board (the lock closes on reset).
  */
-void handleSpecialKeys(char key) {
-    switch (key) {
-        case 'A':
-            // A: Display system information
-            lcd.cls();
-            lcd.printf("Door Lock v1.0");
-            lcd.locate(0, 1);
-            lcd.printf("Attempts: %d", failedAttempts);
-            break;
-            
-        case 'B':
-            // B: Toggle LED brightness (simulate with flash rate)
-            static bool fastFlash = false;
-            fastFlash = !fastFlash;
-            if (fastFlash) {
-                ledTicker.attach(&ledFlashISR, 100ms);  // Faster flash
-                lcd.cls();
-                lcd.printf("Fast Flash ON");
-            } else {
-                ledTicker.attach(&ledFlashISR, 250ms);  // Normal flash
-                lcd.cls();
-                lcd.printf("Normal Flash");
-            }
-            ThisThread::sleep_for(2000);
-            break;
-            
-        case 'C':
-            // C: Clear failed attempts (admin function)
-            if (failedAttempts > 0) {
-                failedAttempts = 0;
-                lcd.cls();
-                lcd.printf("Attempts Reset");
-                ThisThread::sleep_for(2000);
-            } else {
-                lcd.cls();
-                lcd.printf("No Attempts");
-                ThisThread::sleep_for(2000);
-            }
-            break;
-            
-        case 'D':
-            // D: Display lock status and system state
-            lcd.cls();
-            if (isDoorOpen) {
-                lcd.printf("Door: OPEN");
-                int remaining = (OPEN_TIME_MS - doorTimer.read_ms()) / 1000;
-                lcd.locate(0, 1);
-                lcd.printf("Closes in %ds", remaining);
-            } else if (isLockedOut) {
-                lcd.printf("Door: LOCKED");
-                int remaining = (LOCKOUT_TIME_MS - lockoutTimer.read_ms()) / 1000;
-                lcd.locate(0, 1);
-                lcd.printf("Unlock in %ds", remaining);
-            } else {
-                lcd.printf("Door: CLOSED");
-                lcd.locate(0, 1);
-                lcd.printf("Ready");
-            }
-            ThisThread::sleep_for(3000);
-            break;
+void checkDeadlines() {
+    deadlines.record(uiTask, screen.takeLatencyMs(scheduler.nowMs()));
+    if (deadlines.checkpoint()) {
+#if WATCHDOG_ENABLED
+        Watchdog::get_instance().kick();
+#endif
     }
-    updateLCD();  // Return to normal display
 }
 
 // ==================== MAIN PROGRAM ====================
 int main() {
-    // Initialize system
-    lcd.cls();
-    lcd.printf("Door Lock v1.0");
-    lcd.locate(0, 1);
-    lcd.printf("Initializing...");
-    ThisThread::sleep_for(2000);
+    // Stage 1: close the lock and turn the LED ON before anything can fail or wait
+#if TELEMETRY
+    lockDriver.setCompleteHandler(onLockMoved);
+#endif
+    lockDriver.setOpen(false);
+    statusLed.showStatus(StatusIndicator::STATUS_CLOSED);
+    bootTimes.lockMs = scheduler.nowMs();
     
-    // Close lock and turn LED ON
-    closeLock();
+    // Stage 2: park the keypad rows and wake on column edges instead of polling.
+    // Presses are debounced into the keypad's event queue from here on, moved
+    // to the door's mailbox by the input thread and handled as soon as the
+    // event loop runs
+    input.addChannel(keyInput);
+    keyInput.attach(onKeyEvent);
+    keypad.attach(callback(&keyInput, &InputChannel::notify));
+    keypad.setInterruptMode(true);
+    input.start();
+    bootTimes.keypadMs = scheduler.nowMs();
     
-    // Display ready message
-    lcd.cls();
-    lcd.printf("System Ready!");
-    ThisThread::sleep_for(1000);
-    updateLCD();
+    // Stage 3: the UI thread brings the display up while the boot continues
+    display.addScreen(screen);
+    display.start(markDisplayReady);
     
-    // Start timers
-    doorTimer.start();
-    lockoutTimer.start();
+#if ENABLE_PROFILING
+    Profiler::init();
+#if PROFILE_REPORT_PERIOD_MS > 0
+    queue.call_every(std::chrono::milliseconds(PROFILE_REPORT_PERIOD_MS), printProfile);
+#endif
+#endif
     
-    // ==================== MAIN LOOP ====================
-    while (true) {
-        // Check if lockout period expired
-        if (isLockedOut && lockoutTimer.read_ms() >= LOCKOUT_TIME_MS) {
-            resetSystem();
-        }
-        
-        // Check if door should auto-close
-        if (isDoorOpen && doorTimer.read_ms() >= OPEN_TIME_MS) {
-            closeLock();
-            updateLCD();
-        }
-        
-        // Update LCD if door is open (countdown timer)
-        if (isDoorOpen) {
-            updateLCD();
-        }
-        
-        // Read keypad input
-        char key = keypad.getKey();
-        if (key && !isDoorOpen) {  // Ignore input when door is open
-            if (key == '#') {
-                // Submit password
-                if (inputPassword.length() > 0) {
-                    checkPassword();
-                } else {
-                    // No password entered - show message
-                    lcd.cls();
-                    lcd.printf("Enter Password");
-                    lcd.locate(0, 1);
-                    lcd.printf("First!");
-                    ThisThread::sleep_for(2000);
-                    updateLCD();
-                }
-            } else if (key == '*') {
-                // Clear input with confirmation
-                if (inputPassword.length() > 0) {
-                    inputPassword.clear();
-                    updateLCD();
-                } else {
-                    // No input to clear - show message
-                    lcd.cls();
-                    lcd.printf("Nothing to Clear");
-                    ThisThread::sleep_for(1500);
-                    updateLCD();
-                }
-            } else if (key >= '0' && key <= '9') {
-                // Add digit to password (max MAX_PASSWORD_LENGTH digits)
-                if (inputPassword.length() < MAX_PASSWORD_LENGTH) {
-                    inputPassword += key;
-                    updateLCD();
-                }
-            } else if (key == 'A' || key == 'B' || key == 'C' || key == 'D') {
-                // Handle special keys
-                handleSpecialKeys(key);
-            }
-        }
-        
-        ThisThread::sleep_for(100);  // 100ms loop delay
+    // Stage 4: open the PIN store (formats it with PASSWORD as the admin PIN on first boot)
+    bool pinStoreReady = pinStore.init();
+    auditLog.init(pinStore.regionStart());  // Sectors just below the PIN store
+    auditLog.record(AuditLog::EVENT_BOOT);
+    if (ResetReason::get() == RESET_REASON_WATCHDOG) {
+        auditLog.record(AuditLog::EVENT_WATCHDOG_RESET);
     }
+    
+    // Site settings (config.h defaults if nothing valid is stored); the lock
+    // was closed in the default mode and is closed again if the stored one differs
+    runtimeConfig.init(auditLog.regionStart());  // Sectors just below the audit log
+    runtimeConfig.setChangeHandler(onConfigChanged);
+    const DoorSettings& settings = runtimeConfig.settings();
+    keypad.setDebounceTime(settings.debounceTimeMs);
+    LockDriver::Mode lockMode = settings.useRelay ? LockDriver::MODE_RELAY : LockDriver::MODE_SERVO;
+    if (lockMode != lockDriver.mode()) {
+        lockDriver.setMode(lockMode);
+        lockDriver.setOpen(false);
+    }
+    door.setSettings(&settings);
+    bootTimes.storeMs = scheduler.nowMs();
+#if MAINTENANCE_CONSOLE
+    console.setBootTimes(&bootTimes);
+    console.setLock(&lockDriver);
+    console.setDeadlines(&deadlines);
+    console.setConfig(&runtimeConfig);
+    if (pinStoreReady) {
+        console.start();
+    }
+#endif
+    
+    door.setLongPressHandler([](void*) { printProfile(); }, nullptr);
+    door.setIndicator(&statusLed);
+    door.setStats(&systemStats);
+    door.begin(pinStoreReady ? &pinStore : nullptr);
+    bootTimes.readyMs = scheduler.nowMs();  // Buffered keys are handled from here
+    
+    // Deadlines from here on: door timers (declared by the scheduler), keys, screen
+    keyTask = deadlines.declare("keys", 0, DEADLINE_KEY_MS);
+    uiTask = deadlines.declare("ui", DEADLINE_CHECK_MS, DEADLINE_UI_MS);
+    screen.takeLatencyMs(scheduler.nowMs());  // The boot splash waited for the LCD init
+    deadlines.callEvery(DEADLINE_CHECK_MS, [](void*) { checkDeadlines(); }, nullptr);
+#if WATCHDOG_ENABLED
+    Watchdog::get_instance().start(WATCHDOG_TIMEOUT_MS);
+#endif
+#if TELEMETRY
+    TlmBoot boot = {bootTimes.lockMs, bootTimes.keypadMs, bootTimes.storeMs, bootTimes.readyMs};
+    telemetry.emit(TLM_BOOT, boot);
+#if TELEMETRY_COUNTERS_MS > 0
+    queue.call_every(std::chrono::milliseconds(TELEMETRY_COUNTERS_MS), emitCounters);
+#endif
+#if TELEMETRY_STATS_MS > 0
+    queue.call_every(std::chrono::milliseconds(TELEMETRY_STATS_MS), emitStats);
+#endif
+#endif
+    
+    // ==================== EVENT LOOP ====================
+    // Keys, timeouts, auto-close and lockout expiry all arrive as queue
+    // events; the thread sleeps whenever the queue is empty. With
+    // MAINTENANCE_CONSOLE false nothing holds the deep sleep lock while idle
+    // (the solid LED and the released lock are plain GPIOs), so the core sits
+    // in STOP mode until a column edge (EXTI) or a low-power timeout wakes it.
+    // The console's UART RX holds that lock, so with the console enabled (the
+    // default) idle is plain sleep. The deadline heartbeat wakes the core once
+    // per DEADLINE_CHECK_MS to feed the watchdog, which keeps counting in STOP
+    queue.dispatch_forever();
 }
+
+#endif // !BUILD_TESTS && DOOR_CHANNELS == 1
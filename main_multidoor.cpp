@@ -0,0 +1,163 @@
+/**
+ * @file main_multidoor.cpp
+ * @brief Several doors on one board: one keypad, LCD and relay per door
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Built instead of main.cpp when DOOR_CHANNELS > 1. Every door gets a
+ * DoorChannel with its own state machine; the doors share one I2C bus (one
+ * PCF8574 address per LCD), one UI thread, one keypad scan ticker, one input
+ * thread, one timer wheel for their deadlines, the PIN store, the audit log and the console.
+ * Relays only - there is no per-door servo or LED, and the stored lock type
+ * setting is ignored; the other stored settings apply to every door. The
+ * wheel's timers and every door's screen updates are held to their deadlines,
+ * and the watchdog is fed only while they keep them.
+ */
+
+#include "config.h"
+
+#if !defined(BUILD_TESTS) && DOOR_CHANNELS > 1
+
+#if !USE_RELAY
+#error "Multi-door boards drive relays - set USE_RELAY true"
+#endif
+
+#include <mbed.h>
+#include "DoorChannel.h"
+#include "KeypadScanner.h"
+#include "DisplayThread.h"
+#include "InputThread.h"
+#include "QueueScheduler.h"
+#include "TimerWheel.h"
+#include "DeadlineScheduler.h"
+#include "PinStore.h"
+#include "AuditLog.h"
+#include "MaintenanceConsole.h"
+#include "BootTimes.h"
+#include "SystemStats.h"
+#include "RuntimeConfig.h"
+
+// ==================== SHARED HARDWARE ====================
+I2C i2c(PB_7, PB_6);                 // SDA, SCL - every door's LCD backpack
+DisplayThread display;               // UI thread, sole user of the I2C bus
+KeypadScanner scanner;               // One ticker for every keypad
+InputThread input;                   // Every keypad's events to the door thread, above its priority
+
+PinStore pinStore;
+AuditLog auditLog;
+#if MAINTENANCE_CONSOLE
+    MaintenanceConsole console(pinStore, auditLog, USBTX, USBRX);
+#endif
+
+// ==================== EVENT LOOP ====================
+EventQueue queue(32 * EVENTS_EVENT_SIZE);
+QueueScheduler queueScheduler(queue);
+DeadlineScheduler deadlines(queueScheduler);  // Lateness of the wheel's tick (and the heartbeat)
+TimerWheel wheel(deadlines);         // Every door's deadlines on one queue event
+BootTimes bootTimes = {};
+SystemStats systemStats;             // 'A' pages of every door
+RuntimeConfig runtimeConfig;         // Settings shared by every door (console 'config')
+int uiTask = -1;
+
+// ==================== DOORS ====================
+constexpr char keys[ROWS][COLS] = {
+    {'1','2','3','A'},
+    {'4','5','6','B'},
+    {'7','8','9','C'},
+    {'*','0','#','D'}
+};
+
+// One entry per door: keypad rows, keypad columns, LCD address, relay.
+// Keeping each keypad's rows on one port and its columns on another lets the
+// scan use the port registers
+DoorChannel doors[] = {
+    {{{PA_0, PA_1, PA_4, PA_5}, {PB_0, PB_1, PB_3, PB_4}, 0x27, PA_8}, keys, i2c, queue, wheel, auditLog},
+    {{{PC_0, PC_1, PC_2, PC_3}, {PC_6, PC_7, PC_8, PC_9}, 0x26, PB_10}, keys, i2c, queue, wheel, auditLog},
+};
+static_assert(sizeof(doors) / sizeof(doors[0]) == DOOR_CHANNELS, "doors[] needs one entry per DOOR_CHANNELS");
+
+// ==================== BOOT STAGES ====================
+void markDisplayReady() {
+    bootTimes.displayMs = queueScheduler.nowMs();
+}
+
+// ==================== RUNTIME CONFIG ====================
+/**
+ * @brief A setting changed on the console (console thread)
+ */
+void onConfigChanged(int) {
+    scanner.setDebounceTime(runtimeConfig.settings().debounceTimeMs);
+}
+
+// ==================== DEADLINES ====================
+/**
+ * @brief Heartbeat: feed the watchdog only if every task kept its deadline
+ */
+void checkDeadlines() {
+    uint32_t now = queueScheduler.nowMs();
+    for (DoorChannel& door : doors) {
+        deadlines.record(uiTask, door.screen().takeLatencyMs(now));
+    }
+    if (deadlines.checkpoint()) {
+#if WATCHDOG_ENABLED
+        Watchdog::get_instance().kick();
+#endif
+    }
+}
+
+// ==================== MAIN PROGRAM ====================
+int main() {
+    // Stage 1: the relays were driven closed by the DoorChannel constructors
+    bootTimes.lockMs = queueScheduler.nowMs();
+    
+    // Stage 2: every keypad on the shared scanner - presses are queued from here on
+    for (DoorChannel& door : doors) {
+        door.attach(scanner, input, display);
+    }
+    input.start();
+    scanner.start();
+    bootTimes.keypadMs = queueScheduler.nowMs();
+    
+    // Stage 3: the UI thread brings the displays up while the boot continues
+    display.start(markDisplayReady);
+    
+    // Stage 4: shared PIN store and audit log
+    bool pinStoreReady = pinStore.init();
+    auditLog.init(pinStore.regionStart());
+    auditLog.record(AuditLog::EVENT_BOOT);
+    if (ResetReason::get() == RESET_REASON_WATCHDOG) {
+        auditLog.record(AuditLog::EVENT_WATCHDOG_RESET);
+    }
+    runtimeConfig.init(auditLog.regionStart());
+    runtimeConfig.setChangeHandler(onConfigChanged);
+    scanner.setDebounceTime(runtimeConfig.settings().debounceTimeMs);
+    bootTimes.storeMs = queueScheduler.nowMs();
+#if MAINTENANCE_CONSOLE
+    console.setBootTimes(&bootTimes);
+    console.setConfig(&runtimeConfig);
+    console.setDeadlines(&deadlines);
+    if (pinStoreReady) {
+        console.start();
+    }
+#endif
+    
+    for (DoorChannel& door : doors) {
+        door.door().setStats(&systemStats);
+        door.door().setSettings(&runtimeConfig.settings());
+        door.begin(pinStoreReady ? &pinStore : nullptr);
+    }
+    bootTimes.readyMs = queueScheduler.nowMs();
+    
+    uiTask = deadlines.declare("ui", DEADLINE_CHECK_MS, DEADLINE_UI_MS);
+    for (DoorChannel& door : doors) {
+        door.screen().takeLatencyMs(queueScheduler.nowMs());  // Boot splash waited for the LCD init
+    }
+    deadlines.callEvery(DEADLINE_CHECK_MS, [](void*) { checkDeadlines(); }, nullptr);
+#if WATCHDOG_ENABLED
+    Watchdog::get_instance().start(WATCHDOG_TIMEOUT_MS);
+#endif
+    
+    queue.dispatch_forever();
+}
+
+#endif // !BUILD_TESTS && DOOR_CHANNELS > 1
@@ -13,8 +13,8 @@ YELLOW='\033[1;33m'
 BLUE='\033[0;34m'
 NC='\033[0m' # No Color
 
-# Project directory
-PROJECT_DIR="/Users/mugabo15/Mbed Programs/doorLocker"
+# Project directory (the folder above this script)
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
 TESTS_DIR="$PROJECT_DIR/tests"
 BUILD_DIR="$PROJECT_DIR/BUILD"
 
@@ -25,8 +25,24 @@ AVAILABLE_TESTS=(
     "test_led"
     "test_relay"
     "test_integration"
+    "test_benchmark"
+    "test_soak"
 )
 
+# Host tests (built with the native compiler, no board needed)
+HOST_TESTS=(
+    "test_door_sim"
+)
+HOST_SOURCES=(
+    "DoorController.cpp"
+    "LCDFrame.cpp"
+    "TinyFormat.cpp"
+    "TimerWheel.cpp"
+    "DeadlineScheduler.cpp"
+    "DoorSettings.cpp"
+)
+HOST_CXX="${CXX:-g++}"
+
 ###############################################################################
 # Functions
 ###############################################################################
@@ -50,6 +66,8 @@ print_usage() {
     echo "Examples:"
     echo "  $0 test_keypad          # Run keypad test"
     echo "  $0 all                  # Run all tests"
+    echo "  $0 image                # One image with every test (select at boot)"
+    echo "  $0 host                 # Build and run the host simulation"
     echo "  $0 list                 # List available tests"
     echo ""
 }
@@ -145,6 +163,69 @@ run_test() {
     fi
 }
 
+build_test_image() {
+    local image_dir="$BUILD_DIR/test_all"
+    
+    echo -e "${BLUE}========================================"
+    echo "  Building multi-test image"
+    echo -e "========================================${NC}"
+    
+    # main.cpp drops out under BUILD_TESTS, the tests link in under
+    # BUILD_TEST_ALL - nothing is copied, so rebuilds are incremental
+    echo -e "${YELLOW}Compiling...${NC}"
+    cd "$PROJECT_DIR"
+    if ! mbed compile --target NUCLEO_L476RG --toolchain GCC_ARM \
+            -DBUILD_TESTS -DBUILD_TEST_ALL --build "$image_dir"; then
+        echo -e "${RED}✗ Compilation failed!${NC}"
+        return 1
+    fi
+    
+    BIN_FILE=$(find "$image_dir" -name "*.bin" | head -n 1)
+    echo -e "${GREEN}✓ Binary created: $BIN_FILE${NC}"
+    echo ""
+    echo -e "${YELLOW}Next steps:${NC}"
+    echo "  1. Copy binary to board (once):"
+    echo "     cp \"$BIN_FILE\" /Volumes/NODE_L476RG/"
+    echo "  2. Pick a test: type its number at 9600 baud, or hold"
+    echo "     '*' + number on the keypad while pressing reset"
+    echo ""
+    return 0
+}
+
+run_host_tests() {
+    local failed=0
+    mkdir -p "$BUILD_DIR/host"
+    
+    for test in "${HOST_TESTS[@]}"; do
+        local guard="BUILD_$(echo "$test" | tr '[:lower:]' '[:upper:]')"
+        local sources=()
+        for source in "${HOST_SOURCES[@]}"; do
+            sources+=("$PROJECT_DIR/$source")
+        done
+        
+        echo -e "${BLUE}========================================"
+        echo "  Running (host): $test"
+        echo -e "========================================${NC}"
+        
+        echo -e "${YELLOW}Compiling...${NC}"
+        if ! "$HOST_CXX" -std=gnu++14 -O2 -Wall -DBUILD_TESTS -D"$guard" -I"$PROJECT_DIR" \
+                "${sources[@]}" "$TESTS_DIR/$test.cpp" -o "$BUILD_DIR/host/$test"; then
+            echo -e "${RED}✗ Compilation failed!${NC}"
+            failed=1
+            continue
+        fi
+        
+        if "$BUILD_DIR/host/$test" "${@}"; then
+            echo -e "${GREEN}✓ $test passed${NC}"
+        else
+            echo -e "${RED}✗ $test failed${NC}"
+            failed=1
+        fi
+    done
+    
+    return $failed
+}
+
 run_all_tests() {
     echo -e "${BLUE}Running all tests...${NC}"
     echo ""
@@ -177,6 +258,13 @@ run_all_tests() {
 
 print_header
 
+# Host tests need only a C++ compiler
+if [ "$1" == "host" ]; then
+    shift
+    run_host_tests "$@"
+    exit $?
+fi
+
 # Check if mbed CLI is available
 if ! command -v mbed &> /dev/null; then
     echo -e "${RED}✗ Mbed CLI not found!${NC}"
@@ -199,6 +287,9 @@ case "$1" in
     "all")
         run_all_tests
         ;;
+    "image")
+        build_test_image
+        ;;
     "help"|"-h"|"--help")
         print_usage
         ;;
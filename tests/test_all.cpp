@@ -0,0 +1,116 @@
+/**
+ * @file test_all.cpp
+ * @brief Multi-test firmware image: every hardware test behind one dispatcher
+ * @description Links test_keypad, test_lcd, test_led, test_relay and
+ *              test_integration into one image and picks one at boot
+ *
+ * How to use:
+ * 1. Build once with BUILD_TESTS and BUILD_TEST_ALL (./tests/run_test.sh image);
+ *    main.cpp drops out, no file is copied and the build stays incremental
+ * 2. Flash the board once
+ * 3. Select a test:
+ *    - hold '*' and the test number on the keypad while pressing reset, or
+ *    - connect a serial monitor at 9600 baud and type the test number
+ * 4. Reset the board to pick the next test
+ */
+
+#ifdef BUILD_TEST_ALL
+#include "mbed.h"
+#include "Keypad.h"
+
+#include "test_common.h"
+
+using namespace std::chrono_literals;
+
+// Entry points of the linked tests (their main() under BUILD_TEST_ALL)
+namespace test_keypad {
+    int run();
+    extern Keypad<4, 4> keypad;
+}
+namespace test_lcd { int run(); }
+namespace test_led { int run(); }
+namespace test_relay { int run(); }
+namespace test_integration { int run(); }
+
+struct TestEntry {
+    const char* name;
+    int (*run)();
+};
+
+const TestEntry tests[] = {
+    {"test_keypad", test_keypad::run},
+    {"test_lcd", test_lcd::run},
+    {"test_led", test_led::run},
+    {"test_relay", test_relay::run},
+    {"test_integration", test_integration::run},
+};
+const int testCount = sizeof(tests) / sizeof(tests[0]);
+
+/**
+ * @brief Test chosen with a boot-time chord: '*' plus the test number
+ * Uses the keypad test's keypad in polling mode for a short window after reset.
+ * @return Test index, or -1 if no chord is held
+ */
+int chordSelection() {
+    bool starDown = false;
+    char digitDown = 0;
+
+    Timer window;
+    window.start();
+    while (window.elapsed_time() < 200ms) {  // Several debounce periods
+        KeyEvent event;
+        while (test_keypad::keypad.pollEvent(event)) {
+            bool down = event.type == KeyEvent::Press;
+            if (event.key == '*') {
+                starDown = down;
+            } else if (event.key >= '1' && event.key <= '9') {
+                digitDown = down ? event.key : 0;
+            }
+        }
+        ThisThread::sleep_for(5ms);
+    }
+
+    if (starDown && digitDown && digitDown - '1' < testCount) {
+        return digitDown - '1';
+    }
+    return -1;
+}
+
+/**
+ * @brief Print the menu and wait for a test number on the serial port
+ * @return Test index
+ */
+int serialSelection() {
+    pc_printf("\n");
+    pc_printf("========================================\n");
+    pc_printf("  DOOR LOCK HARDWARE TESTS\n");
+    pc_printf("========================================\n");
+    for (int i = 0; i < testCount; i++) {
+        pc_printf("  %d. %s\n", i + 1, tests[i].name);
+    }
+    pc_printf("========================================\n");
+    pc_printf("Type a test number (or reset holding '*' + number)\n");
+
+    while (true) {
+        char c = 0;
+        pc.read(&c, 1);  // Blocks until a character arrives
+        if (c >= '1' && c - '1' < testCount) {
+            return c - '1';
+        }
+    }
+}
+
+int main() {
+    int selected = chordSelection();
+
+    while (true) {
+        if (selected < 0) {
+            selected = serialSelection();
+        }
+        pc_printf("\n[SELECT] %s\n", tests[selected].name);
+        tests[selected].run();  // Most tests loop until reset
+        selected = -1;
+    }
+}
+
+#endif // BUILD_TEST_ALL
@@ -0,0 +1,357 @@
+/**
+ * @file test_benchmark.cpp
+ * @brief On-target benchmark suite for the door lock hot paths
+ * @description Measures keypad, LCD, I2C, ticker and unlock timing and prints
+ *              the results as CSV over the serial port
+ *
+ * How to use:
+ * 1. Comment out main.cpp in your build
+ * 2. Compile this test file instead (BUILD_TEST_BENCHMARK)
+ * 3. Connect serial monitor at 9600 baud and capture the output
+ * 4. Press keys when asked (latency and unlock tests)
+ *
+ * Output format (one result per line, easy to diff between builds/boards):
+ *   # comment / context lines
+ *   BENCH,<name>,<unit>,<samples>,<min>,<avg>,<max>
+ * With TELEMETRY each result is also streamed as a TLM_BENCH frame.
+ */
+
+#ifdef BUILD_TEST_BENCHMARK
+#include "mbed.h"
+#include "Keypad.h"
+#include "PCF8574LCD.h"
+#include "LCDFrame.h"
+#include "PinStore.h"
+#include "config.h"
+
+#include "test_common.h"
+
+using namespace std::chrono_literals;
+
+// Keypad Configuration
+const PinName rowPins[4] = {PA_0, PA_1, PA_4, PA_5};
+const PinName colPins[4] = {PB_0, PB_1, PB_3, PB_4};
+
+constexpr char keys[4][4] = {
+    {'1','2','3','A'},
+    {'4','5','6','B'},
+    {'7','8','9','C'},
+    {'*','0','#','D'}
+};
+
+Keypad<4, 4> keypad(keys, rowPins, colPins);
+
+// I2C LCD Configuration
+I2C i2c(PB_7, PB_6);  // SDA, SCL
+PCF8574LCD lcd(i2c, LCD_I2C_ADDRESS);
+LCDFrameBuffer display(lcd);
+
+// Lock control (relay pin - the servo build uses the same pin)
+DigitalOut lockControl(PA_8);
+
+PinStore pinStore;
+
+/**
+ * @brief Running min/avg/max of one measurement
+ */
+struct Stats {
+    uint32_t samples = 0;
+    uint32_t min = 0xFFFFFFFF;
+    uint32_t max = 0;
+    uint64_t total = 0;
+
+    void add(uint32_t value) {
+        samples++;
+        total += value;
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+
+    void print(const char* name, const char* unit) const {
+        if (samples == 0) {
+            pc_printf("BENCH,%s,%s,0,,,\n", name, unit);
+            return;
+        }
+        pc_printf("BENCH,%s,%s,%lu,%lu,%lu,%lu\n", name, unit, (unsigned long)samples,
+                  (unsigned long)min, (unsigned long)(total / samples), (unsigned long)max);
+#if TELEMETRY
+        tlmBench(name, samples, min, (uint32_t)(total / samples), max);
+#endif
+    }
+};
+
+/**
+ * @brief Wait for the next key press (interrupt mode)
+ * @return false on timeout
+ */
+bool waitForPress(KeyEvent& event, Kernel::Clock::duration_u32 timeout) {
+    while (keypad.waitForActivity(timeout)) {
+        while (keypad.pollEvent(event)) {
+            if (event.type == KeyEvent::Press) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Benchmark 1: Keypad full scan (polling mode, no key pressed)
+ */
+void bench_keypad_scan() {
+    pc_printf("# keypad backend=%s\n", keypad.usesPortScan() ? "port" : "pins");
+    keypad.setInterruptMode(false);
+
+    Stats stats;
+    Timer timer;
+    KeyEvent event;
+    for (int i = 0; i < 1000; i++) {
+        timer.reset();
+        timer.start();
+        keypad.pollEvent(event);  // One scan + debounce step
+        timer.stop();
+        stats.add(timer.elapsed_time().count());
+    }
+    stats.print("keypad_full_scan", "us");
+}
+
+/**
+ * @brief Benchmark 2: Press detection latency (edge to debounced event)
+ */
+void bench_keypad_latency() {
+    pc_printf("# press any key 10 times (10s timeout each)\n");
+    keypad.setInterruptMode(true);
+
+    Stats latency;
+    KeyEvent event;
+    for (int i = 0; i < 10; i++) {
+        if (!waitForPress(event, 10s)) {
+            pc_printf("# timeout waiting for key\n");
+            break;
+        }
+        latency.add(event.timestampUs - keypad.lastWakeUs());
+    }
+    latency.print("keypad_press_latency", "us");
+}
+
+/**
+ * @brief Benchmark 3: LCD updates and I2C throughput
+ */
+void bench_lcd() {
+    LCDFrame frame;
+    Timer timer;
+
+    // Composing the countdown screen (formatting only, no bus traffic)
+    Stats compose;
+    for (int i = 0; i < 100; i++) {
+        timer.reset();
+        timer.start();
+        frame.clear();
+        frame.print("Door Open");
+        frame.locate(0, 1);
+        frame.printf("Closing in %ds", i % 10);
+        timer.stop();
+        compose.add(timer.elapsed_time().count());
+    }
+    compose.print("lcd_compose_countdown", "us");
+    
+    // Start from a known screen
+    display.invalidate();
+    display.present(frame);
+
+    // Single cell: one character changes per update
+    Stats cell;
+    for (int i = 0; i < 50; i++) {
+        frame.locate(15, 1);
+        frame.putc('0' + i % 10);
+        timer.reset();
+        timer.start();
+        display.present(frame);
+        timer.stop();
+        cell.add(timer.elapsed_time().count());
+    }
+    cell.print("lcd_single_cell", "us");
+
+    // Countdown bar: one step per update, so one cell (full block or CGRAM glyph)
+    frame.locate(0, 1);
+    frame.bar(LCD_COLUMNS, LCD_COLUMNS * 5, LCD_COLUMNS * 5);
+    display.present(frame);
+    Stats barStep;
+    uint32_t barBytesBefore = lcd.bytesSent();
+    uint32_t uploadsBefore = display.glyphUploads();
+    for (int i = LCD_COLUMNS * 5 - 1; i >= 0; i--) {
+        frame.locate(0, 1);
+        frame.bar(LCD_COLUMNS, i, LCD_COLUMNS * 5);
+        timer.reset();
+        timer.start();
+        display.present(frame);
+        timer.stop();
+        barStep.add(timer.elapsed_time().count());
+    }
+    barStep.print("lcd_bar_step", "us");
+    pc_printf("# bar: %lu bytes per step, %lu glyph uploads\n",
+              (unsigned long)((lcd.bytesSent() - barBytesBefore) / (LCD_COLUMNS * 5)),
+              (unsigned long)(display.glyphUploads() - uploadsBefore));
+
+    // One full line
+    Stats line;
+    for (int i = 0; i < 20; i++) {
+        frame.locate(0, 0);
+        for (int c = 0; c < LCD_COLUMNS; c++) {
+            frame.putc('A' + (i + c) % 26);
+        }
+        timer.reset();
+        timer.start();
+        display.present(frame);
+        timer.stop();
+        line.add(timer.elapsed_time().count());
+    }
+    line.print("lcd_line", "us");
+
+    // Full frame rewrite, also used for the bus throughput
+    Stats full;
+    uint32_t bytesBefore = lcd.bytesSent();
+    uint64_t busyUs = 0;
+    for (int i = 0; i < 20; i++) {
+        frame.clear();
+        frame.printf("Frame %d", i);
+        frame.locate(0, 1);
+        frame.printf("0123456789ABCDEF");
+        display.invalidate();
+        timer.reset();
+        timer.start();
+        display.present(frame);
+        timer.stop();
+        full.add(timer.elapsed_time().count());
+        busyUs += timer.elapsed_time().count();
+    }
+    full.print("lcd_full_frame", "us");
+
+    uint32_t bytes = lcd.bytesSent() - bytesBefore;
+    uint32_t rate = busyUs ? (uint32_t)((uint64_t)bytes * 1000000 / busyUs) : 0;
+    pc_printf("# i2c frequency=%d bytes=%lu\n", LCD_I2C_FREQUENCY_HZ, (unsigned long)bytes);
+    pc_printf("BENCH,i2c_throughput,bytes_per_s,1,%lu,%lu,%lu\n",
+              (unsigned long)rate, (unsigned long)rate, (unsigned long)rate);
+#if TELEMETRY
+    tlmBench("i2c_throughput", 1, rate, rate, rate);
+#endif
+}
+
+// Ticker jitter state (written in the ISR)
+volatile uint32_t tickLastUs = 0;
+volatile uint32_t tickCount = 0;
+volatile uint32_t tickMinUs = 0xFFFFFFFF;
+volatile uint32_t tickMaxUs = 0;
+volatile uint64_t tickTotalUs = 0;
+
+void tickISR() {
+    uint32_t now = us_ticker_read();
+    if (tickCount > 0) {
+        uint32_t period = now - tickLastUs;
+        tickMinUs = period < tickMinUs ? period : tickMinUs;
+        tickMaxUs = period > tickMaxUs ? period : tickMaxUs;
+        tickTotalUs += period;
+    }
+    tickLastUs = now;
+    tickCount++;
+}
+
+/**
+ * @brief Measure the period spread of a ticker running the LED flash period
+ */
+template <typename TickerType>
+void bench_ticker(const char* name) {
+    tickCount = 0;
+    tickMinUs = 0xFFFFFFFF;
+    tickMaxUs = 0;
+    tickTotalUs = 0;
+
+    TickerType ticker;
+    ticker.attach(&tickISR, 250ms);
+    ThisThread::sleep_for(5250ms);  // ~20 periods
+    ticker.detach();
+
+    uint32_t periods = tickCount > 0 ? tickCount - 1 : 0;
+    if (periods == 0) {
+        pc_printf("BENCH,%s_period,us,0,,,\n", name);
+        return;
+    }
+    uint32_t avg = (uint32_t)(tickTotalUs / periods);
+    pc_printf("BENCH,%s_period,us,%lu,%lu,%lu,%lu\n", name, (unsigned long)periods,
+              (unsigned long)tickMinUs, (unsigned long)avg, (unsigned long)tickMaxUs);
+
+    // Jitter is derived from the period figures - a comment, not a result line
+    pc_printf("# %s jitter: %lu us peak-to-peak, nominal period 250000 us\n", name,
+              (unsigned long)(tickMaxUs - tickMinUs));
+}
+
+/**
+ * @brief Benchmark 5: '#' press to lock actuation
+ * Same path as the application: PIN store lookup, then the lock output.
+ */
+void bench_unlock() {
+    if (!pinStore.init()) {
+        pc_printf("# PIN store unavailable\n");
+        return;
+    }
+    pc_printf("# kdf_rounds=%lu\n", (unsigned long)pinStore.kdfIterations());
+    pc_printf("# enter the admin PIN and press # (3 times)\n");
+    keypad.setInterruptMode(true);
+
+    Stats unlock;
+    Stats hash;
+    char pin[MAX_PASSWORD_LENGTH];
+    KeyEvent event;
+    for (int attempt = 0; attempt < 3; attempt++) {
+        size_t length = 0;
+        while (waitForPress(event, 30s)) {
+            if (event.key == '#') {
+                break;
+            }
+            if (event.key >= '0' && event.key <= '9' && length < sizeof(pin)) {
+                pin[length++] = event.key;
+            }
+        }
+        if (event.key != '#') {
+            pc_printf("# timeout waiting for PIN\n");
+            break;
+        }
+
+        bool granted = pinStore.verify(pin, length);
+        hash.add(pinStore.lastHashUs());
+        if (granted) {
+            lockControl = 1;
+            unlock.add(us_ticker_read() - event.timestampUs);
+            ThisThread::sleep_for(500ms);
+            lockControl = 0;
+        } else {
+            pc_printf("# wrong PIN, not counted\n");
+        }
+    }
+    hash.print("pin_hash", "us");
+    unlock.print("hash_key_to_actuation", "us");
+}
+
+int main() {
+    pc_printf("\n# ========================================\n");
+    pc_printf("# Door Lock Benchmark Suite\n");
+    pc_printf("# build=%s %s core_clock=%lu\n", __DATE__, __TIME__, (unsigned long)SystemCoreClock);
+    pc_printf("# ========================================\n");
+    pc_printf("BENCH,name,unit,samples,min,avg,max\n");
+
+    lcd.init();
+
+    bench_keypad_scan();
+    bench_lcd();
+    bench_ticker<Ticker>("ticker");
+    bench_ticker<LowPowerTicker>("lp_ticker");
+    bench_keypad_latency();
+    bench_unlock();
+
+    pc_printf("# done\n");
+    while (true) {
+        ThisThread::sleep_for(1s);
+    }
+}
+
+#endif // BUILD_TEST_BENCHMARK
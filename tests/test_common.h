@@ -0,0 +1,90 @@
+/**
+ * @file test_common.h
+ * @brief Serial output and build glue shared by the on-target test programs
+ * @author Door Locker Project
+ * @date 2025
+ *
+ * Each test builds on its own (BUILD_TEST_KEYPAD, BUILD_TEST_LCD, ...) or, with
+ * BUILD_TEST_ALL, all of them link into one image with the test_all.cpp
+ * dispatcher. In that build every test is wrapped in its own namespace and its
+ * main() becomes <namespace>::run(), so the file-level globals do not clash.
+ *
+ * With TELEMETRY set in config.h, testTelemetry() also streams binary frames
+ * on USART1 TX (PA_9) at TELEMETRY_BAUD, which costs the code under test far
+ * less than formatted text at 9600 baud (decode with tools/telemetry_decode.py).
+ *
+ * Usage in a test file:
+ *   #include "test_common.h"
+ *   TEST_SUITE_BEGIN(test_led)
+ *   ... globals and helpers ...
+ *   TEST_MAIN() { ... }
+ *   TEST_SUITE_END()
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include "mbed.h"
+#include "TinyFormat.h"
+#include "config.h"
+#if TELEMETRY
+#include "Telemetry.h"
+#endif
+
+#include <cstdarg>
+
+#ifdef BUILD_TEST_ALL
+#define TEST_SUITE_BEGIN(name) namespace name {
+#define TEST_SUITE_END()       }
+#define TEST_MAIN()            int run()
+#else
+#define TEST_SUITE_BEGIN(name)
+#define TEST_SUITE_END()
+#define TEST_MAIN()            int main()
+#endif
+
+/**
+ * @brief The one serial port of every test (one instance, however many tests are linked)
+ */
+inline BufferedSerial& testSerial() {
+    static BufferedSerial serial(USBTX, USBRX, 9600);
+    return serial;
+}
+
+// Serial output for debugging
+static BufferedSerial& pc = testSerial();
+
+inline void pc_printf(const char *format, ...) TINY_FORMAT_CHECK(1, 2);
+
+inline void pc_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    tinyVWrite(pc, format, args);
+    va_end(args);
+}
+
+#if TELEMETRY
+/**
+ * @brief The telemetry stream of every test (one instance, however many tests are linked)
+ */
+inline Telemetry& testTelemetry() {
+    static Telemetry telemetry(PA_9);
+    return telemetry;
+}
+
+/**
+ * @brief Stream one benchmark result (TLM_BENCH)
+ */
+inline void tlmBench(const char* name, uint32_t samples, uint32_t min, uint32_t avg, uint32_t max) {
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    const uint32_t values[4] = {samples, min, avg, max};
+    memcpy(payload, values, sizeof(values));  // Little-endian target, same layout as the decoder
+    size_t nameLength = strlen(name);
+    nameLength = nameLength < sizeof(payload) - sizeof(values) ? nameLength : sizeof(payload) - sizeof(values);
+    memcpy(payload + sizeof(values), name, nameLength);
+    testTelemetry().emit(TLM_BENCH, payload, sizeof(values) + nameLength);
+}
+#endif
+
+#endif // TEST_COMMON_H
@@ -0,0 +1,1030 @@
+/**
+ * @file test_door_sim.cpp
+ * @brief Host simulation of the door state machine
+ * @description Runs DoorController against fake keypad, display, lock and audit
+ *              log under a virtual clock: scripted scenarios, exact timing checks
+ *              (auto-close, lockout), a random key fuzzer with invariants,
+ *              several doors sharing one TimerWheel, deadline tracking under
+ *              a stalled event loop, runtime door settings and the
+ *              countdown bar
+ *
+ * How to use (no board needed):
+ *   ./tests/run_test.sh host            # build with g++ and run
+ * or by hand from the project root:
+ *   g++ -std=gnu++14 -O2 -DBUILD_TESTS -DBUILD_TEST_DOOR_SIM -I. \
+ *       DoorController.cpp LCDFrame.cpp TinyFormat.cpp TimerWheel.cpp \
+ *       DeadlineScheduler.cpp DoorSettings.cpp \
+ *       tests/test_door_sim.cpp -o door_sim
+ *   ./door_sim [fuzz_keys] [seed]
+ *
+ * Exit status is 0 only if every check passed.
+ */
+
+#ifdef BUILD_TEST_DOOR_SIM
+
+#include "DoorController.h"
+#include "TimerWheel.h"
+#include "DeadlineScheduler.h"
+#include "config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Test counters
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+// ==================== FAKES ====================
+
+/**
+ * @brief Virtual clock: time only moves in advance(), tasks run in deadline order
+ */
+class SimScheduler : public Scheduler {
+public:
+    explicit SimScheduler(uint32_t startMs) : _now(startMs), _nextId(1), _order(0) {
+        memset(_slots, 0, sizeof(_slots));
+    }
+
+    uint32_t nowMs() override {
+        return _now;
+    }
+
+    int callIn(uint32_t delayMs, Task task, void* context) override {
+        return add(delayMs, 0, task, context);
+    }
+
+    int callEvery(uint32_t periodMs, Task task, void* context) override {
+        return add(periodMs, periodMs, task, context);
+    }
+
+    void cancel(int id) override {
+        for (Slot& slot : _slots) {
+            if (slot.task && slot.id == id) {
+                slot.task = nullptr;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Move the clock forward, running every task that falls due
+     */
+    void advance(uint32_t ms) {
+        uint32_t target = _now + ms;
+        while (true) {
+            Slot* next = nullptr;
+            for (Slot& slot : _slots) {
+                if (!slot.task || static_cast<int32_t>(slot.due - target) > 0) {
+                    continue;
+                }
+                if (!next || static_cast<int32_t>(slot.due - next->due) < 0 ||
+                    (slot.due == next->due && slot.order < next->order)) {
+                    next = &slot;
+                }
+            }
+            if (!next) {
+                break;
+            }
+            if (static_cast<int32_t>(next->due - _now) > 0) {
+                _now = next->due;  // Overdue tasks (after a stall) run at the current time
+            }
+            Task task = next->task;
+            void* context = next->context;
+            if (next->period) {
+                next->due += next->period;
+                next->order = _order++;
+            } else {
+                next->task = nullptr;
+            }
+            task(context);
+        }
+        _now = target;
+    }
+
+    /**
+     * @brief Move the clock forward without running anything (a blocked event loop)
+     */
+    void stall(uint32_t ms) {
+        _now += ms;
+    }
+
+    int pending() const {
+        int count = 0;
+        for (const Slot& slot : _slots) {
+            count += slot.task != nullptr;
+        }
+        return count;
+    }
+
+private:
+    struct Slot {
+        int id;
+        uint32_t due;
+        uint32_t period;            // 0 = one-shot
+        uint64_t order;             // FIFO among equal deadlines, like the EventQueue
+        Task task;                  // nullptr = free
+        void* context;
+    };
+
+    static const int SLOTS = 16;
+
+    int add(uint32_t delayMs, uint32_t periodMs, Task task, void* context) {
+        for (Slot& slot : _slots) {
+            if (!slot.task) {
+                slot.id = _nextId++;
+                slot.due = _now + delayMs;
+                slot.period = periodMs;
+                slot.order = _order++;
+                slot.task = task;
+                slot.context = context;
+                return slot.id;
+            }
+        }
+        printf("[FAIL] scheduler out of slots - pending tasks leak\n");
+        exit(1);
+    }
+
+    Slot _slots[SLOTS];
+    uint32_t _now;
+    int _nextId;
+    uint64_t _order;
+};
+
+/**
+ * @brief Key queue filled by the test
+ */
+class SimKeys : public KeySource {
+public:
+    SimKeys() : _head(0), _tail(0) {}
+
+    bool pollEvent(KeyEvent& event) override {
+        if (_head == _tail) {
+            return false;
+        }
+        event = _events[_tail++ % CAPACITY];
+        return true;
+    }
+
+    void push(char key, KeyEvent::Type type, uint32_t timestampUs) {
+        KeyEvent& event = _events[_head++ % CAPACITY];
+        event.key = key;
+        event.type = type;
+        event.flags = 0;
+        event.timestampUs = timestampUs;
+    }
+
+private:
+    static const uint32_t CAPACITY = 16;
+    KeyEvent _events[CAPACITY];
+    uint32_t _head;
+    uint32_t _tail;
+};
+
+/**
+ * @brief Keeps the last frame and the backlight state
+ */
+class SimDisplay : public DisplaySink {
+public:
+    SimDisplay() : frames(0), backlight(true) {}
+
+    void submit(const LCDFrame& frame) override {
+        screen = frame;
+        frames++;
+    }
+
+    void setBacklight(bool on) override {
+        backlight = on;
+    }
+
+    /**
+     * @brief Does a screen line show text, from the start or from a column?
+     */
+    bool shows(int row, const char* text, int column = 0) const {
+        for (int i = 0; text[i]; i++) {
+            if (column + i >= LCD_COLUMNS || screen.at(column + i, row) != text[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Is a glyph in a cell?
+     */
+    bool showsGlyph(int column, int row, Glyph glyph) const {
+        return screen.at(column, row) == LCDFrame::glyphCode(glyph);
+    }
+
+    LCDFrame screen;
+    uint32_t frames;
+    bool backlight;
+};
+
+/**
+ * @brief Records when the lock was released and how long it stayed open
+ */
+class SimLock : public LockActuator {
+public:
+    explicit SimLock(SimScheduler& clock)
+        : open(false), authorised(false), opens(0), unauthorisedOpens(0), openedAt(0),
+          shortestOpenMs(0xFFFFFFFF), longestOpenMs(0), _clock(clock) {}
+
+    void setOpen(bool value) override {
+        if (value && !open) {
+            opens++;
+            unauthorisedOpens += !authorised;
+            openedAt = _clock.nowMs();
+        } else if (!value && open) {
+            uint32_t duration = _clock.nowMs() - openedAt;
+            shortestOpenMs = duration < shortestOpenMs ? duration : shortestOpenMs;
+            longestOpenMs = duration > longestOpenMs ? duration : longestOpenMs;
+        }
+        authorised = false;
+        open = value;
+    }
+
+    bool open;
+    bool authorised;                // Set by SimVerifier on a correct PIN
+    uint32_t opens;
+    uint32_t unauthorisedOpens;
+    uint32_t openedAt;
+    uint32_t shortestOpenMs;
+    uint32_t longestOpenMs;
+
+private:
+    SimScheduler& _clock;
+};
+
+/**
+ * @brief Records the status light pattern and brightness
+ */
+class SimIndicator : public StatusIndicator {
+public:
+    SimIndicator() : status(STATUS_CLOSED), brightness(255), changes(0) {}
+
+    void showStatus(Status value) override {
+        status = value;
+        changes++;
+    }
+
+    void setBrightness(uint8_t level) override {
+        brightness = level;
+    }
+
+    Status status;
+    uint8_t brightness;
+    uint32_t changes;
+};
+
+/**
+ * @brief Fixed memory and CPU figures with two threads
+ */
+class SimStats : public SystemStatsSource {
+public:
+    void summary(Summary& out) override {
+        out = {90061000u, 81000000u, 72000000u, 45000000u, 1234u, 2345u, 65536u, 0u};
+    }
+
+    int stacks(Stack* out, int max) override {
+        static const Stack threads[] = {{"main", 1800, 4096}, {"ui", 700, 1024}};
+        int count = max < 2 ? max : 2;
+        for (int i = 0; i < count; i++) {
+            out[i] = threads[i];
+        }
+        return count;
+    }
+};
+
+/**
+ * @brief Accepts PASSWORD (admin) and one extra user PIN
+ */
+class SimVerifier : public PinVerifier {
+public:
+    static const uint16_t EXTRA_USER = 7;
+
+    SimVerifier(SimLock& lock, const char* extraPin) : _lock(lock), _extraPin(extraPin) {}
+
+    bool verify(const char* pin, size_t length, uint16_t* userId) override {
+        uint16_t owner = AuditSink::NO_USER;
+        if (length == strlen(PASSWORD) && memcmp(pin, PASSWORD, length) == 0) {
+            owner = ADMIN_USER_ID;
+        } else if (length == strlen(_extraPin) && memcmp(pin, _extraPin, length) == 0) {
+            owner = EXTRA_USER;
+        }
+        if (owner == AuditSink::NO_USER) {
+            return false;
+        }
+        _lock.authorised = true;
+        if (userId) {
+            *userId = owner;
+        }
+        return true;
+    }
+
+private:
+    SimLock& _lock;
+    const char* _extraPin;
+};
+
+/**
+ * @brief Counts events and measures every lockout
+ */
+class SimAudit : public AuditSink {
+public:
+    explicit SimAudit(SimScheduler& clock)
+        : grants(0), denials(0), lockouts(0), lastUser(NO_USER), lockedAt(0),
+          shortestLockoutMs(0xFFFFFFFF), longestLockoutMs(0), _clock(clock) {}
+
+    void record(Event event, uint8_t, uint16_t userId) override {
+        switch (event) {
+            case EVENT_ACCESS_GRANTED:
+                grants++;
+                lastUser = userId;
+                break;
+            case EVENT_ACCESS_DENIED:
+                denials++;
+                break;
+            case EVENT_LOCKOUT:
+                lockouts++;
+                lockedAt = _clock.nowMs();
+                break;
+            case EVENT_LOCKOUT_END: {
+                uint32_t duration = _clock.nowMs() - lockedAt;
+                shortestLockoutMs = duration < shortestLockoutMs ? duration : shortestLockoutMs;
+                longestLockoutMs = duration > longestLockoutMs ? duration : longestLockoutMs;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    uint32_t grants;
+    uint32_t denials;
+    uint32_t lockouts;
+    uint16_t lastUser;
+    uint32_t lockedAt;
+    uint32_t shortestLockoutMs;
+    uint32_t longestLockoutMs;
+
+private:
+    SimScheduler& _clock;
+};
+
+/**
+ * @brief One simulated board: fakes wired to a controller
+ */
+struct Rig {
+    // Start just before the 32-bit millisecond wrap so every run crosses it
+    explicit Rig(bool withVerifier = true, uint32_t startMs = 0xFFFFF000u, uint32_t bootMs = 3000)
+        : clock(startMs), lock(clock), verifier(lock, "9999"), audit(clock),
+          door(keys, display, lock, clock, audit), longPresses(0) {
+        door.setLongPressHandler(&Rig::onLongPress, this);
+        door.setIndicator(&indicator);
+        door.begin(withVerifier ? &verifier : nullptr);
+        clock.advance(bootMs);       // Past the splash screen
+    }
+
+    static void onLongPress(void* self) {
+        static_cast<Rig*>(self)->longPresses++;
+    }
+
+    /**
+     * @brief Press and release a key, then let holdMs pass
+     */
+    void press(char key, uint32_t holdMs = 50) {
+        keys.push(key, KeyEvent::Press, clock.nowMs() * 1000u);
+        door.processKeys();
+        clock.advance(holdMs);
+        keys.push(key, KeyEvent::Release, clock.nowMs() * 1000u);
+        door.processKeys();
+    }
+
+    void type(const char* text) {
+        while (*text) {
+            press(*text++);
+            clock.advance(100);
+        }
+    }
+
+    SimScheduler clock;
+    SimKeys keys;
+    SimDisplay display;
+    SimLock lock;
+    SimVerifier verifier;
+    SimAudit audit;
+    SimIndicator indicator;
+    DoorController door;
+    int longPresses;
+};
+
+// ==================== TEST HELPERS ====================
+
+void printTestHeader(const char* testName) {
+    printf("\n");
+    printf("========================================\n");
+    printf("[TEST] %s\n", testName);
+    printf("========================================\n");
+}
+
+void reportResult(bool passed, const char* message) {
+    testsRun++;
+    if (passed) {
+        testsPassed++;
+        printf("[PASS] %s\n", message);
+    } else {
+        testsFailed++;
+        printf("[FAIL] %s\n", message);
+    }
+}
+
+/**
+ * @brief Type a wrong PIN MAX_FAILED_ATTEMPTS times, ending at the last '#'
+ */
+void lockOut(Rig& rig) {
+    for (int i = 0; i < MAX_FAILED_ATTEMPTS; i++) {
+        rig.type("0000");
+        rig.press('#', 0);
+        if (i + 1 < MAX_FAILED_ATTEMPTS) {
+            rig.clock.advance(2500);  // Past "Wrong Password!"
+        }
+    }
+}
+
+// ==================== SCENARIOS ====================
+
+void test_boot() {
+    printTestHeader("Boot");
+    Rig rig;
+    reportResult(rig.door.state() == DoorController::State::Idle, "Idle after the splash screens");
+    reportResult(rig.display.shows(0, "Enter Password:"), "Password prompt shown");
+    reportResult(!rig.lock.open, "Lock engaged");
+    reportResult(rig.indicator.status == StatusIndicator::STATUS_CLOSED, "Status light shows closed");
+
+    Rig early(true, 0xFFFFF000u, 0);
+    reportResult(BOOT_SPLASH_MS == 0 || early.display.shows(1, "System Ready!"), "Splash screen shown");
+    early.press('1', 0);
+    reportResult(early.door.state() == DoorController::State::Entering && early.display.shows(1, "*"),
+                 "First key skips the splash screen");
+}
+
+void test_auto_close() {
+    printTestHeader("Correct PIN and auto-close");
+    Rig rig;
+    rig.type(PASSWORD);
+    rig.press('#', 0);
+    uint32_t openedAt = rig.clock.nowMs();
+    reportResult(rig.lock.open && rig.door.isDoorOpen(), "Correct PIN opens the lock");
+    reportResult(rig.display.shows(0, "Access Granted!"), "Access Granted! shown");
+    reportResult(rig.audit.lastUser == ADMIN_USER_ID, "Grant logged for the admin user");
+    reportResult(rig.indicator.status == StatusIndicator::STATUS_OPEN, "Status light shows open");
+
+    rig.clock.advance(2500);
+    reportResult(rig.door.state() == DoorController::State::Open, "Open state after the message");
+    reportResult(rig.display.shows(0, "Door Open") && rig.display.showsGlyph(0, 1, Glyph::Unlocked) &&
+                 rig.display.shows(1, "  8s", 1), "Countdown shown");
+
+    rig.type("9999#");
+    reportResult(rig.lock.opens == 1 && rig.door.inputLength() == 0, "Keys ignored while open");
+
+    rig.clock.advance(openedAt + OPEN_TIME_MS - 1 - rig.clock.nowMs());
+    reportResult(rig.lock.open, "Still open 1ms before OPEN_TIME_MS");
+    rig.clock.advance(1);
+    reportResult(!rig.lock.open, "Closed exactly at OPEN_TIME_MS");
+    reportResult(rig.indicator.status == StatusIndicator::STATUS_CLOSED, "Status light back to closed");
+    reportResult(rig.display.shows(0, "Enter Password:"), "Back to the password prompt");
+}
+
+void test_second_user() {
+    printTestHeader("PIN verifier");
+    Rig rig;
+    rig.type("9999#");
+    reportResult(rig.lock.open && rig.audit.lastUser == SimVerifier::EXTRA_USER,
+                 "Second user's PIN opens, logged with their id");
+
+    Rig fallback(false);
+    reportResult(fallback.indicator.status == StatusIndicator::STATUS_FAULT,
+                 "Status light shows a fault without a PIN store");
+    fallback.type(PASSWORD);
+    fallback.press('#');
+    reportResult(fallback.lock.open, "Without a PIN store the compiled-in PASSWORD opens");
+    fallback.clock.advance(OPEN_TIME_MS);
+    fallback.type("9999#");
+    reportResult(!fallback.lock.open && fallback.door.failedAttempts() == 1,
+                 "Without a PIN store other PINs are rejected");
+}
+
+void test_lockout() {
+    printTestHeader("Lockout");
+    Rig rig;
+    lockOut(rig);
+    uint32_t lockedAt = rig.clock.nowMs();
+    reportResult(rig.door.isLockedOut(), "Locked out after MAX_FAILED_ATTEMPTS");
+    reportResult(rig.indicator.status == StatusIndicator::STATUS_LOCKOUT, "Status light shows the lockout");
+
+    rig.clock.advance(4500);  // Past both lockout messages
+    reportResult(rig.display.shows(0, "LOCKED OUT!") && rig.display.showsGlyph(0, 1, Glyph::Locked),
+                 "Lockout screen shown");
+    rig.type(PASSWORD);
+    rig.press('#');
+    reportResult(!rig.lock.open && rig.door.inputLength() == 0, "PIN ignored during the lockout");
+    rig.press('A');
+    reportResult(rig.door.state() == DoorController::State::Menu, "Information keys still work");
+
+    rig.clock.advance(lockedAt + LOCKOUT_TIME_MS - 1 - rig.clock.nowMs());
+    reportResult(rig.door.isLockedOut(), "Still locked out 1ms before LOCKOUT_TIME_MS");
+    rig.clock.advance(1);
+    reportResult(!rig.door.isLockedOut() && rig.door.failedAttempts() == 0,
+                 "Lockout ends exactly at LOCKOUT_TIME_MS and clears the attempts");
+    reportResult(rig.indicator.status == StatusIndicator::STATUS_CLOSED, "Status light back to closed");
+    rig.type(PASSWORD);
+    rig.press('#');
+    reportResult(rig.lock.open, "Correct PIN works again");
+}
+
+void test_keys() {
+    printTestHeader("Editing and special keys");
+    Rig rig;
+    rig.type("12");
+    reportResult(rig.display.shows(1, "**"), "Digits shown masked");
+    rig.press('*');
+    reportResult(rig.door.inputLength() == 0 && rig.door.state() == DoorController::State::Idle,
+                 "'*' clears the input");
+    rig.type("123456789");
+    reportResult(rig.door.inputLength() == MAX_PASSWORD_LENGTH, "Input capped at MAX_PASSWORD_LENGTH");
+    rig.press('#');
+    rig.press('C');
+    reportResult(rig.door.failedAttempts() == 0 && rig.display.shows(0, "Attempts Reset"),
+                 "'C' clears the failed attempts");
+    rig.press('D');
+    reportResult(rig.display.shows(0, "Door: CLOSED"), "'D' shows the door status");
+    rig.clock.advance(3000);
+    reportResult(rig.door.state() == DoorController::State::Idle, "Menu screen times out");
+
+    rig.press('B');
+    reportResult(rig.indicator.brightness == 128 && rig.display.shows(1, "50%"), "'B' dims the status light");
+    rig.press('B');
+    rig.press('B');
+    rig.press('B');
+    reportResult(rig.indicator.brightness == 255 && rig.display.shows(1, "100%"),
+                 "'B' cycles back to full brightness");
+
+    rig.press('A', LONG_PRESS_MS - 1);
+    reportResult(rig.longPresses == 0, "Short 'A' is not a long press");
+    rig.press('A', LONG_PRESS_MS);
+    reportResult(rig.longPresses == 1, "'A' held for LONG_PRESS_MS calls the handler");
+}
+
+void test_stats_pages() {
+    printTestHeader("Diagnostics pages");
+    Rig rig;
+    rig.press('A');
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Door Lock v1.0"), "Without stats 'A' stays on the version page");
+
+    SimStats stats;
+    rig.door.setStats(&stats);
+    rig.clock.advance(3000);
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Door Lock v1.0") && rig.display.shows(1, "Attempts: 0"),
+                 "First 'A' shows the version page");
+    rig.press('A');
+    reportResult(rig.display.shows(1, "1d 01:01:01"), "Second 'A' shows the uptime");
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Idle Slp  Deep") && rig.display.shows(1, " 89%  79%  49%"),
+                 "Third 'A' shows the CPU residency");
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Heap 1234/65536") && rig.display.shows(1, "Max 2345 Fail 0"),
+                 "Fourth 'A' shows the heap");
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Stack main") && rig.display.shows(1, "1800/4096 bytes"),
+                 "Then one page per thread stack");
+    rig.press('A');
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Door Lock v1.0"), "Pages wrap to the version page");
+
+    rig.press('A');
+    rig.clock.advance(STATS_PAGE_MS);
+    reportResult(rig.door.state() == DoorController::State::Idle, "Page times out after STATS_PAGE_MS");
+    rig.press('A');
+    reportResult(rig.display.shows(0, "Door Lock v1.0"), "Next 'A' starts again at the first page");
+}
+
+void test_countdown_bar() {
+    printTestHeader("Countdown bar");
+    const int barStart = LCD_COLUMNS - COUNTDOWN_BAR_CELLS;
+
+    LCDFrame frame;
+    frame.bar(3, 7, 15);
+    reportResult(frame.at(0, 0) == GLYPH_FULL_BLOCK && frame.at(1, 0) == LCDFrame::glyphCode(Glyph::Bar2) &&
+                 frame.at(2, 0) == ' ', "Bar of 7/15 is a full block, 2 of 5 columns, blank");
+    frame.clear();
+    frame.bar(3, 1, 1000);
+    reportResult(frame.at(0, 0) == LCDFrame::glyphCode(Glyph::Bar1), "Bar rounds up, one column until empty");
+
+    Rig rig;
+    rig.type(PASSWORD);
+    rig.press('#', 0);
+    rig.clock.advance(2000);  // Past Access Granted
+    bool full = true;
+    for (int col = barStart; col < barStart + 8; col++) {
+        full = full && rig.display.screen.at(col, 1) == GLYPH_FULL_BLOCK;
+    }
+    reportResult(full && rig.display.shows(1, "  8s ", 1) && rig.display.shows(1, "  ", barStart + 8),
+                 "8s of 10s left: 8 of 10 bar cells lit");
+
+    // One bar step per refresh, one cell changed per step
+    uint32_t stepMs = OPEN_TIME_MS / (COUNTDOWN_BAR_CELLS * 5);
+    int steps = 0;
+    bool oneCell = true;
+    bool neverEmpty = true;
+    LCDFrame before = rig.display.screen;
+    rig.clock.advance(stepMs);
+    while (rig.door.isDoorOpen()) {
+        int changed = 0;
+        for (int col = barStart; col < LCD_COLUMNS; col++) {
+            changed += rig.display.screen.at(col, 1) != before.at(col, 1) ? 1 : 0;
+        }
+        oneCell = oneCell && changed == 1;
+        neverEmpty = neverEmpty && rig.display.screen.at(barStart, 1) != ' ';
+        steps++;
+        before = rig.display.screen;
+        rig.clock.advance(stepMs);
+    }
+    reportResult(oneCell && steps == (int)((OPEN_TIME_MS - 2000) / stepMs) - 1,
+                 "Each refresh moves the bar one step and changes one cell");
+    reportResult(neverEmpty && before.at(barStart, 1) == LCDFrame::glyphCode(Glyph::Bar1),
+                 "Bar keeps one column lit until the door closes");
+
+    rig.press('D');
+    reportResult(rig.display.shows(0, "Door: CLOSED") && rig.display.showsGlyph(LCD_COLUMNS - 1, 0, Glyph::Locked),
+                 "'D' shows the closed lock icon");
+}
+
+void test_settings() {
+    printTestHeader("Runtime settings");
+    DoorSettings settings = DoorSettings::defaults();
+    reportResult(settings.valid() && settings.openTimeMs == OPEN_TIME_MS &&
+                 settings.maxFailedAttempts == MAX_FAILED_ATTEMPTS, "Defaults are the config.h values");
+    int open = DoorSettings::find("open_ms");
+    int attempts = DoorSettings::find("attempts");
+    reportResult(open >= 0 && attempts >= 0 && DoorSettings::find("nonsense") < 0, "Settings found by name");
+    reportResult(!settings.set(open, 999) && !settings.set(attempts, 0) && settings.get(open) == OPEN_TIME_MS,
+                 "Out-of-range values rejected, nothing changed");
+
+    Rig rig;
+    settings.set(open, 5000);
+    settings.set(attempts, 5);
+    rig.door.setSettings(&settings);
+    rig.type(PASSWORD "#");
+    rig.clock.advance(6000);
+    reportResult(!rig.lock.open && rig.lock.longestOpenMs == 5000, "New open time used from the next open");
+
+    for (int i = 0; i < MAX_FAILED_ATTEMPTS; i++) {
+        rig.type("0000#");
+        rig.clock.advance(2500);
+    }
+    reportResult(!rig.door.isLockedOut(), "Raised attempt limit not yet reached");
+    rig.type("0000#");
+    rig.clock.advance(2500);
+    rig.type("0000");
+    rig.press('#', 0);
+    uint32_t lockedAt = rig.clock.nowMs();
+    reportResult(rig.door.isLockedOut(), "Lockout after the new attempt limit");
+    settings.set(DoorSettings::find("lockout_ms"), 1000);
+    rig.clock.advance(lockedAt + LOCKOUT_TIME_MS - 1 - rig.clock.nowMs());
+    reportResult(rig.door.isLockedOut(), "Running lockout keeps its length when the setting changes");
+    rig.clock.advance(1);
+    for (int i = 0; i < 5; i++) {
+        rig.type("0000#");
+        rig.clock.advance(2500);
+    }
+    rig.clock.advance(1000);
+    reportResult(!rig.door.isLockedOut(), "Next lockout takes the new length");
+}
+
+void test_backlight() {
+    printTestHeader("Backlight");
+    Rig rig;
+    rig.press('1', 0);
+    rig.clock.advance(BACKLIGHT_TIMEOUT_MS - 1);
+    reportResult(rig.display.backlight, "On until the idle timeout");
+    rig.clock.advance(1);
+    reportResult(!rig.display.backlight, "Off after BACKLIGHT_TIMEOUT_MS idle");
+    rig.press('2');
+    reportResult(rig.display.backlight, "Any key turns it back on");
+
+    rig.press('*');
+    rig.type(PASSWORD);
+    rig.press('#', 0);
+    rig.clock.advance(BACKLIGHT_TIMEOUT_MS - 1);
+    reportResult(rig.display.backlight, "Stays on while the door is open");
+}
+
+// ==================== FUZZING ====================
+
+/**
+ * @brief xorshift32 - fast and reproducible from the seed
+ */
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief Random keys at random intervals, checking the invariants after each one
+ */
+void test_fuzz(uint32_t keyCount, uint32_t seed) {
+    printTestHeader("Random key fuzzing");
+    printf("  - %lu keys, seed %lu\n", (unsigned long)keyCount, (unsigned long)seed);
+
+    static const char layout[] = "0123456789*#ABCD";
+    Rig rig;
+    uint32_t random = seed ? seed : 1;
+    uint32_t violations = 0;
+    uint32_t firstViolation = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < keyCount; i++) {
+        uint32_t r = nextRandom(random);
+        if (r % 64 == 0) {
+            rig.type(PASSWORD "#");  // Keep the open path busy, not only failures
+        }
+        char key = layout[(r >> 8) % 16];
+        // Mostly typing speed, sometimes long pauses past every timeout
+        uint32_t gap = (r >> 16) % 16 == 0 ? (r >> 12) % 40000 : (r >> 20) % 400;
+        rig.press(key, (r >> 4) % 120);
+        rig.clock.advance(gap);
+
+        bool ok = rig.lock.open == rig.door.isDoorOpen()
+            && !(rig.door.isDoorOpen() && rig.door.isLockedOut())
+            && rig.door.failedAttempts() <= MAX_FAILED_ATTEMPTS
+            && rig.door.inputLength() <= MAX_PASSWORD_LENGTH
+            && rig.lock.unauthorisedOpens == 0
+            && rig.indicator.status == (rig.door.isDoorOpen() ? StatusIndicator::STATUS_OPEN
+                                        : rig.door.isLockedOut() ? StatusIndicator::STATUS_LOCKOUT
+                                        : StatusIndicator::STATUS_CLOSED)
+            && rig.clock.pending() <= 6;
+        if (!ok && violations++ == 0) {
+            firstViolation = i;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Let the last open period and lockout run out
+    rig.clock.advance(LOCKOUT_TIME_MS + OPEN_TIME_MS);
+
+    if (violations) {
+        printf("  - first violation after key %lu\n", (unsigned long)firstViolation);
+    }
+    printf("  - %lu opens, %lu denials, %lu lockouts\n", (unsigned long)rig.lock.opens,
+           (unsigned long)rig.audit.denials, (unsigned long)rig.audit.lockouts);
+    printf("  - open time %lu..%lu ms, lockout %lu..%lu ms\n",
+           (unsigned long)rig.lock.shortestOpenMs, (unsigned long)rig.lock.longestOpenMs,
+           (unsigned long)rig.audit.shortestLockoutMs, (unsigned long)rig.audit.longestLockoutMs);
+    printf("  - %.0f key events/s (%.2fs)\n", keyCount * 2 / seconds, seconds);
+
+    reportResult(violations == 0, "Invariants hold after every key");
+    reportResult(rig.lock.opens > 0 && rig.audit.lockouts > 0, "Fuzzer reached open and lockout");
+    reportResult(rig.audit.grants == rig.lock.opens, "Every open is a logged grant");
+    reportResult(rig.lock.shortestOpenMs == OPEN_TIME_MS && rig.lock.longestOpenMs == OPEN_TIME_MS,
+                 "Every open lasted exactly OPEN_TIME_MS");
+    reportResult(rig.audit.shortestLockoutMs == LOCKOUT_TIME_MS && rig.audit.longestLockoutMs == LOCKOUT_TIME_MS,
+                 "Every lockout lasted exactly LOCKOUT_TIME_MS");
+    reportResult(!rig.lock.open && !rig.door.isLockedOut(), "Closed and unlocked once idle");
+}
+
+// ==================== MULTI-DOOR ====================
+
+/**
+ * @brief One door of a multi-door board: its own fakes, the board's clock and wheel
+ */
+struct Channel {
+    Channel(SimScheduler& clock, Scheduler& scheduler)
+        : clock(clock), lock(clock), verifier(lock, "9999"), audit(clock),
+          door(keys, display, lock, scheduler, audit) {
+        door.begin(&verifier);
+    }
+
+    void press(char key, uint32_t holdMs = 50) {
+        keys.push(key, KeyEvent::Press, clock.nowMs() * 1000u);
+        door.processKeys();
+        clock.advance(holdMs);
+        keys.push(key, KeyEvent::Release, clock.nowMs() * 1000u);
+        door.processKeys();
+    }
+
+    void type(const char* text) {
+        while (*text) {
+            press(*text++);
+            clock.advance(100);
+        }
+    }
+
+    SimScheduler& clock;
+    SimKeys keys;
+    SimDisplay display;
+    SimLock lock;
+    SimVerifier verifier;
+    SimAudit audit;
+    DoorController door;
+};
+
+/**
+ * @brief Is a measured period within the wheel's rounding of the expected one?
+ */
+bool withinTick(uint32_t shortestMs, uint32_t longestMs, uint32_t expectedMs) {
+    return shortestMs >= expectedMs && longestMs < expectedMs + TIMER_WHEEL_TICK_MS;
+}
+
+void test_multi_door(uint32_t keyCount, uint32_t seed) {
+    printTestHeader("Doors sharing one TimerWheel");
+    static const int DOORS = 4;
+    SimScheduler clock(0xFFFFF000u);
+    TimerWheel wheel(clock);
+    Channel* doors[DOORS];
+    for (Channel*& channel : doors) {
+        channel = new Channel(clock, wheel);
+    }
+    clock.advance(3000);
+    reportResult(clock.pending() == 1, "All deadlines on one base task");
+
+    // Door 1 locks out, door 0 opens, door 2 is in use, door 3 is left alone
+    for (int i = 0; i < MAX_FAILED_ATTEMPTS; i++) {
+        doors[1]->type("0000#");
+        clock.advance(2500);
+    }
+    doors[0]->type(PASSWORD "#");
+    doors[2]->type("12");
+    clock.advance(2500);
+    reportResult(doors[0]->lock.open && doors[1]->door.isLockedOut() && doors[2]->door.inputLength() == 2 &&
+                 doors[3]->door.state() == DoorController::State::Idle, "Each door keeps its own state");
+    reportResult(doors[1]->display.shows(0, "LOCKED OUT!") && doors[0]->display.shows(0, "Door Open"),
+                 "Each door drives its own display");
+
+    clock.advance(LOCKOUT_TIME_MS + OPEN_TIME_MS);
+    reportResult(withinTick(doors[0]->lock.shortestOpenMs, doors[0]->lock.longestOpenMs, OPEN_TIME_MS),
+                 "Open time within one tick of OPEN_TIME_MS");
+    reportResult(withinTick(doors[1]->audit.shortestLockoutMs, doors[1]->audit.longestLockoutMs, LOCKOUT_TIME_MS),
+                 "Lockout within one tick of LOCKOUT_TIME_MS");
+    clock.advance(BACKLIGHT_TIMEOUT_MS + TIMER_WHEEL_TICK_MS);
+    bool dark = true;
+    for (Channel* channel : doors) {
+        dark = dark && !channel->display.backlight;
+    }
+    reportResult(dark && wheel.pending() == 0 && clock.pending() == 0,
+                 "Tick stops once every door is idle");
+
+    // Random keys on random doors
+    static const char layout[] = "0123456789*#ABCD";
+    uint32_t random = seed ? seed : 1;
+    uint32_t violations = 0;
+    for (uint32_t i = 0; i < keyCount; i++) {
+        uint32_t r = nextRandom(random);
+        Channel& channel = *doors[r % DOORS];
+        if ((r >> 2) % 64 == 0) {
+            channel.type(PASSWORD "#");
+        }
+        uint32_t gap = (r >> 16) % 16 == 0 ? (r >> 12) % 40000 : (r >> 20) % 400;
+        channel.press(layout[(r >> 8) % 16], (r >> 4) % 120);
+        clock.advance(gap);
+
+        for (Channel* door : doors) {
+            bool ok = door->lock.open == door->door.isDoorOpen()
+                && !(door->door.isDoorOpen() && door->door.isLockedOut())
+                && door->door.failedAttempts() <= MAX_FAILED_ATTEMPTS
+                && door->lock.unauthorisedOpens == 0;
+            violations += !ok;
+        }
+    }
+    clock.advance(LOCKOUT_TIME_MS + OPEN_TIME_MS);
+
+    bool timing = true;
+    uint32_t opens = 0;
+    for (Channel* channel : doors) {
+        opens += channel->lock.opens;
+        timing = timing && withinTick(channel->lock.shortestOpenMs, channel->lock.longestOpenMs, OPEN_TIME_MS);
+        if (channel->audit.lockouts) {
+            timing = timing && withinTick(channel->audit.shortestLockoutMs, channel->audit.longestLockoutMs,
+                                          LOCKOUT_TIME_MS);
+        }
+    }
+    printf("  - %lu keys over %d doors, %lu opens, %lu wheel overflows\n", (unsigned long)keyCount, DOORS,
+           (unsigned long)opens, (unsigned long)wheel.overflows());
+    reportResult(violations == 0, "Invariants hold on every door");
+    reportResult(timing, "Every open and lockout within one tick of its duration");
+    reportResult(wheel.overflows() == 0, "Timer pool never overflowed");
+
+    for (Channel* channel : doors) {
+        delete channel;
+    }
+}
+
+// ==================== DEADLINES ====================
+
+void countRun(void* runs) {
+    (*static_cast<int*>(runs))++;
+}
+
+void test_deadlines() {
+    printTestHeader("Deadline tracking");
+    SimScheduler clock(0xFFFFF000u);
+    DeadlineScheduler deadlines(clock, 100);
+    const DeadlineScheduler::TaskStats& timers = deadlines.task(DeadlineScheduler::TASK_TIMERS);
+    int runs = 0;
+
+    deadlines.callIn(500, countRun, &runs);
+    clock.advance(500);
+    reportResult(runs == 1 && timers.runs == 1 && timers.worstLateMs == 0, "On-time timer runs 0ms late");
+    reportResult(deadlines.checkpoint(), "Checkpoint passes with every deadline met");
+
+    deadlines.callIn(500, countRun, &runs);
+    clock.advance(400);
+    clock.stall(300);
+    clock.advance(0);
+    reportResult(runs == 2 && timers.worstLateMs == 200 && timers.overruns == 1,
+                 "Stall past the due time recorded as lateness and one overrun");
+    reportResult(!deadlines.checkpoint(), "Checkpoint fails after the overrun");
+    reportResult(deadlines.checkpoint() && deadlines.failedCheckpoints() == 1, "... and passes again after it");
+
+    int id = deadlines.callEvery(1000, countRun, &runs);
+    clock.advance(3000);
+    reportResult(runs == 5 && timers.overruns == 1, "Periodic timer re-armed on time");
+    deadlines.cancel(id);
+    clock.advance(2000);
+    reportResult(runs == 5 && clock.pending() == 0, "Cancelled timer stops and frees its base task");
+
+    int keys = deadlines.declare("keys", 0, 150);
+    deadlines.record(keys, 150);
+    bool met = deadlines.checkpoint();
+    deadlines.record(keys, 151);
+    reportResult(met && !deadlines.checkpoint() && deadlines.task(keys).worstLateMs == 151,
+                 "Declared task held to its own deadline");
+
+    for (int i = 0; i <= DEADLINE_SLOTS; i++) {
+        deadlines.callIn(100, countRun, &runs);
+    }
+    clock.advance(100);
+    reportResult(runs == 5 + DEADLINE_SLOTS + 1 && deadlines.untracked() == 1,
+                 "Timers beyond DEADLINE_SLOTS still run, counted as untracked");
+
+    // The door's auto-close through a stalled loop: late by exactly the recorded lateness
+    deadlines.resetStats();
+    Channel channel(clock, deadlines);
+    clock.advance(3000);
+    channel.type(PASSWORD "#");
+    clock.advance(OPEN_TIME_MS - 1000);
+    clock.stall(1300);
+    clock.advance(0);
+    printf("  - auto-close after %lu ms, timers worst %lu ms late\n", (unsigned long)channel.lock.longestOpenMs,
+           (unsigned long)timers.worstLateMs);
+    reportResult(!channel.lock.open && channel.lock.longestOpenMs > OPEN_TIME_MS &&
+                 channel.lock.longestOpenMs <= OPEN_TIME_MS + timers.worstLateMs,
+                 "Auto-close within OPEN_TIME_MS + worst timer lateness");
+    reportResult(!deadlines.checkpoint(), "Stalled door timers fail the checkpoint");
+}
+
+// ==================== SUMMARY ====================
+
+void printSummary() {
+    printf("\n");
+    printf("========================================\n");
+    printf("  TEST SUMMARY\n");
+    printf("========================================\n");
+    printf("Total Tests: %d\n", testsRun);
+    printf("Passed: %d\n", testsPassed);
+    printf("Failed: %d\n", testsFailed);
+    printf("========================================\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t keyCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+    uint32_t seed = argc > 2 ? strtoul(argv[2], nullptr, 0) : 0x2545F491;
+
+    printf("========================================\n");
+    printf("  Door State Machine - Host Simulation\n");
+    printf("========================================\n");
+
+    test_boot();
+    test_auto_close();
+    test_second_user();
+    test_lockout();
+    test_keys();
+    test_stats_pages();
+    test_countdown_bar();
+    test_settings();
+    test_backlight();
+    test_fuzz(keyCount, seed);
+    test_multi_door(keyCount / 10, seed);
+    test_deadlines();
+
+    printSummary();
+    return testsFailed == 0 ? 0 : 1;
+}
+
+#endif // BUILD_TEST_DOOR_SIM
@@ -11,32 +11,17 @@
  * 5. Follow test prompts
  */
 
-#ifdef BUILD_TEST_INTEGRATION
+#if defined(BUILD_TEST_INTEGRATION) || defined(BUILD_TEST_ALL)
 
 #include "mbed.h"
 #include "TextLCD.h"
 #include "Keypad.h"
 
-#include <cstdarg>
-#include <cstdio>
+#include "test_common.h"
 
 using namespace std::chrono_literals;
 
-void pc_printf(const char *format, ...)
-{
-    char buffer[256];
-    va_list args;
-    va_start(args, format);
-    int len = vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
-    if (len <= 0) {
-        return;
-    }
-    if (len > static_cast<int>(sizeof(buffer))) {
-        len = sizeof(buffer);
-    }
-    pc.write(buffer, len);
-}
+TEST_SUITE_BEGIN(test_integration)
 
 // I2C LCD
 I2C i2c(PB_7, PB_6);
@@ -49,15 +34,15 @@ DigitalOut led(PC_13);
 DigitalOut relay(PA_8);
 
 // Keypad
-PinName rowPins[4] = {PA_0, PA_1, PA_4, PA_5};
-PinName colPins[4] = {PB_0, PB_1, PB_3, PB_4};
-char keys[4][4] = {
+const PinName rowPins[4] = {PA_0, PA_1, PA_4, PA_5};
+const PinName colPins[4] = {PB_0, PB_1, PB_3, PB_4};
+constexpr char keys[4][4] = {
     {'1','2','3','A'},
     {'4','5','6','B'},
     {'7','8','9','C'},
     {'*','0','#','D'}
 };
-Keypad keypad(keys, rowPins, colPins, 4, 4);
+Keypad<4, 4> keypad(keys, rowPins, colPins);
 
 // Ticker for LED flashing
 Ticker ledTicker;
@@ -277,7 +262,7 @@ bool test_password_entry() {
                 for (size_t i = 0; i < input.length(); i++) {
                     lcd.printf("*");
                 }
-                pc_printf("  - Digit entered: '%c' (total: %d digits)\n", key, input.length());
+                pc_printf("  - Digit entered: '%c' (total: %d digits)\n", key, (int)input.length());
             }
         }
         
@@ -463,7 +448,7 @@ void printSummary() {
     pc_printf("Total tests run: %d\n", testsRun);
     pc_printf("Tests passed:    %d\n", testsPassed);
     pc_printf("Tests failed:    %d\n", testsFailed);
-    pc_printf("Success rate:    %.1f%%\n", (float)testsPassed / testsRun * 100);
+    pc_printf("Success rate:    %d%%\n", testsRun ? testsPassed * 100 / testsRun : 0);
     pc_printf("========================================\n");
     
     lcd.cls();
@@ -479,7 +464,7 @@ void printSummary() {
 /**
  * @brief Main test function
  */
-int main() {
+TEST_MAIN() {
     // Initialize hardware
     led = 0;
     relay = 0;
@@ -543,4 +528,6 @@ int main() {
     }
 }
 
+TEST_SUITE_END()
+
 #endif // BUILD_TEST_INTEGRATION
@@ -10,46 +10,28 @@
  * 4. Press keys and verify output
  */
 
-#ifdef BUILD_TEST_KEYPAD
+#if defined(BUILD_TEST_KEYPAD) || defined(BUILD_TEST_ALL)
 #include "mbed.h"
 #include "Keypad.h"
 
-#include <cstdarg>
-#include <cstdio>
+#include "test_common.h"
 
 using namespace std::chrono_literals;
 
-// Serial output for debugging
-BufferedSerial pc(USBTX, USBRX, 9600);
-
-void pc_printf(const char *format, ...)
-{
-    char buffer[256];
-    va_list args;
-    va_start(args, format);
-    int len = vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
-    if (len <= 0) {
-        return;
-    }
-    if (len > static_cast<int>(sizeof(buffer))) {
-        len = sizeof(buffer);
-    }
-    pc.write(buffer, len);
-}
+TEST_SUITE_BEGIN(test_keypad)
 
 // Keypad Configuration
-PinName rowPins[4] = {PA_0, PA_1, PA_4, PA_5};
-PinName colPins[4] = {PB_0, PB_1, PB_3, PB_4};
+const PinName rowPins[4] = {PA_0, PA_1, PA_4, PA_5};
+const PinName colPins[4] = {PB_0, PB_1, PB_3, PB_4};
 
-char keys[4][4] = {
+constexpr char keys[4][4] = {
     {'1','2','3','A'},
     {'4','5','6','B'},
     {'7','8','9','C'},
     {'*','0','#','D'}
 };
 
-Keypad keypad(keys, rowPins, colPins, 4, 4);
+Keypad<4, 4> keypad(keys, rowPins, colPins);
 
 // LED for visual feedback
 DigitalOut led(PC_13);
@@ -123,7 +105,7 @@ void printStatistics() {
 /**
  * @brief Main test function
  */
-int main() {
+TEST_MAIN() {
     // Initialize LED (OFF = 0)
     led = 0;
     
@@ -175,4 +157,6 @@ int main() {
     }
 }
 
+TEST_SUITE_END()
+
 #endif // BUILD_TEST_KEYPAD
@@ -10,34 +10,15 @@
  * 4. Connect serial monitor to see test progress
  */
 
-#ifdef BUILD_TEST_LCD
+#if defined(BUILD_TEST_LCD) || defined(BUILD_TEST_ALL)
 #include "mbed.h"
 #include "TextLCD.h"
 
-#include <cstdarg>
-#include <cstdio>
+#include "test_common.h"
 
 using namespace std::chrono_literals;
 
-// Serial output for debugging
-BufferedSerial pc(USBTX, USBRX, 9600);
-
-
-void pc_printf(const char *format, ...)
-{
-    char buffer[256];
-    va_list args;
-    va_start(args, format);
-    int len = vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
-    if (len <= 0) {
-        return;
-    }
-    if (len > static_cast<int>(sizeof(buffer))) {
-        len = sizeof(buffer);
-    }
-    pc.write(buffer, len);
-}
+TEST_SUITE_BEGIN(test_lcd)
 
 // I2C LCD Configuration
 I2C i2c(PB_7, PB_6);  // SDA, SCL
@@ -297,7 +278,7 @@ void test_full_demo() {
 /**
  * @brief Main test function
  */
-int main() {
+TEST_MAIN() {
     // Initialize LED
     led = 0;
     
@@ -353,4 +334,6 @@ int main() {
     }
 }
 
+TEST_SUITE_END()
+
 #endif // BUILD_TEST_LCD
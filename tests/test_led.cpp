@@ -1,60 +1,27 @@
 /**
  * @file test_led.cpp
- * @brief Test program for LED Indicator
- * @description Tests LED flashing patterns and timing
+ * @brief Test program for the status LED
+ * @description Plays the LedPattern tables through LedEngine: blink rates,
+ *              SOS, heartbeat, brightness levels and the door status patterns
  * 
  * How to use:
- * 1. Comment out main.cpp in your build
- * 2. Compile this test file instead
- * 3. Connect serial monitor at 9600 baud
- * 4. Watch LED on board (PC_13)
+ * 1. Build with BUILD_TESTS and BUILD_TEST_LED (or the BUILD_TEST_ALL image)
+ * 2. Connect serial monitor at 9600 baud
+ * 3. Watch the status LED (PB_8, on a timer channel)
  */
 
-#ifdef BUILD_TEST_LED
+#if defined(BUILD_TEST_LED) || defined(BUILD_TEST_ALL)
 #include "mbed.h"
+#include "LedEngine.h"
 
-#include <cstdarg>
-#include <cstdio>
+#include "test_common.h"
 
 using namespace std::chrono_literals;
 
-// Serial output for debugging
-BufferedSerial pc(USBTX, USBRX, 9600);
+TEST_SUITE_BEGIN(test_led)
 
-void pc_printf(const char *format, ...)
-{
-    char buffer[256];
-    va_list args;
-    va_start(args, format);
-    int len = vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
-    if (len <= 0) {
-        return;
-    }
-    if (len > static_cast<int>(sizeof(buffer))) {
-        len = sizeof(buffer);
-    }
-    pc.write(buffer, len);
-}
-
-
-// LED on PC_13 (built-in on most Nucleo boards)
-DigitalOut led(PC_13);
-
-// Ticker for interrupt-based flashing
-Ticker ledTicker;
-
-// Global variables for ticker tests
-volatile bool tickerActive = false;
-volatile int tickCount = 0;
-
-/**
- * @brief LED toggle ISR for Ticker
- */
-void ledToggleISR() {
-    led = !led;
-    tickCount++;
-}
+// Status LED on PB_8 (TIM4_CH3)
+LedEngine led(PB_8);
 
 /**
  * @brief Prints test header
@@ -65,22 +32,34 @@ void printHeader() {
     pc_printf("  LED INDICATOR TEST PROGRAM\n");
     pc_printf("========================================\n");
     pc_printf("Hardware: STM32 Nucleo\n");
-    pc_printf("LED Pin: PC_13 (built-in)\n");
+    pc_printf("LED Pin: PB_8 (%s)\n", STATUS_LED_PWM ? "PWM" : "GPIO");
     pc_printf("Baud Rate: 9600\n");
     pc_printf("========================================\n");
     pc_printf("\n");
     pc_printf("Test Sequence:\n");
     pc_printf("  1. Basic ON/OFF Test\n");
-    pc_printf("  2. Blinking Pattern Test\n");
-    pc_printf("  3. PWM Brightness Test (if supported)\n");
-    pc_printf("  4. Ticker-based Flashing Test\n");
-    pc_printf("  5. Door Lock Simulation\n");
+    pc_printf("  2. Pattern Table Test\n");
+    pc_printf("  3. Brightness Test\n");
+    pc_printf("  4. Door Status Patterns\n");
+    pc_printf("  5. Interrupt Load Test\n");
     pc_printf("\n");
     pc_printf("Watch the LED on your board!\n");
     pc_printf("========================================\n");
     pc_printf("\n");
 }
 
+/**
+ * @brief Play a pattern for a while, reporting the step interrupts it took
+ */
+void playFor(const char* name, const LedPattern& pattern, Kernel::Clock::duration_u32 duration) {
+    uint32_t before = led.stepInterrupts();
+    led.play(pattern);
+    bool hardware = led.inHardware();
+    ThisThread::sleep_for(duration);
+    pc_printf("  - %-12s %s, %lu step interrupts\n", name, hardware ? "timer only" : "stepped",
+              (unsigned long)(led.stepInterrupts() - before));
+}
+
 /**
  * @brief Test 1: Basic ON/OFF Test
  */
@@ -89,11 +68,11 @@ void test_basic_onoff() {
     
     for (int i = 0; i < 5; i++) {
         pc_printf("  - Cycle %d/5: LED ON (1s)...", i + 1);
-        led = 1;
+        led.play(LED_SOLID);
         ThisThread::sleep_for(1s);
         
         pc_printf(" LED OFF (1s)\n");
-        led = 0;
+        led.play(LED_OFF);
         ThisThread::sleep_for(1s);
     }
     
@@ -101,233 +80,92 @@ void test_basic_onoff() {
 }
 
 /**
- * @brief Test 2: Blinking Pattern Test
+ * @brief Test 2: Every pattern table
  */
-void test_blinking_patterns() {
-    pc_printf("\n[TEST 2] Blinking Pattern Test\n");
-    
-    // Pattern 1: Fast blink (5 Hz)
-    pc_printf("  - Pattern 1: Fast blink (5 Hz, 200ms period)\n");
-    for (int i = 0; i < 20; i++) {
-        led = !led;
-        ThisThread::sleep_for(100ms);
-    }
-    led = 0;
-    ThisThread::sleep_for(1s);
+void test_patterns() {
+    pc_printf("\n[TEST 2] Pattern Table Test\n");
     
-    // Pattern 2: Medium blink (2 Hz)
-    pc_printf("  - Pattern 2: Medium blink (2 Hz, 500ms period)\n");
-    for (int i = 0; i < 10; i++) {
-        led = !led;
-        ThisThread::sleep_for(250ms);
-    }
-    led = 0;
-    ThisThread::sleep_for(1s);
-    
-    // Pattern 3: Slow blink (1 Hz)
-    pc_printf("  - Pattern 3: Slow blink (1 Hz, 1000ms period)\n");
-    for (int i = 0; i < 6; i++) {
-        led = !led;
-        ThisThread::sleep_for(500ms);
-    }
-    led = 0;
-    ThisThread::sleep_for(1s);
-    
-    // Pattern 4: SOS Morse code
-    pc_printf("  - Pattern 4: SOS Morse code\n");
-    
-    // S (dot-dot-dot)
-    for (int i = 0; i < 3; i++) {
-        led = 1;
-        ThisThread::sleep_for(200ms);
-        led = 0;
-        ThisThread::sleep_for(200ms);
-    }
-    ThisThread::sleep_for(400ms);
-    
-    // O (dash-dash-dash)
-    for (int i = 0; i < 3; i++) {
-        led = 1;
-        ThisThread::sleep_for(600ms);
-        led = 0;
-        ThisThread::sleep_for(200ms);
-    }
-    ThisThread::sleep_for(400ms);
-    
-    // S (dot-dot-dot)
-    for (int i = 0; i < 3; i++) {
-        led = 1;
-        ThisThread::sleep_for(200ms);
-        led = 0;
-        ThisThread::sleep_for(200ms);
-    }
+    playFor("fast blink", LED_FAST_BLINK, 4s);
+    playFor("blink", LED_BLINK, 4s);
+    playFor("double blink", LED_DOUBLE_BLINK, 4s);
+    playFor("SOS", LED_SOS, 6s);
+    playFor("heartbeat", LED_HEARTBEAT, 5s);
+    playFor("breathe", LED_BREATHE, 6s);
+    led.play(LED_OFF);
     
     pc_printf("  - Test complete.\n");
     ThisThread::sleep_for(2s);
 }
 
 /**
- * @brief Test 3: Ticker-based Flashing Test
+ * @brief Test 3: Brightness levels of the 'B' key
  */
-void test_ticker_flashing() {
-    pc_printf("\n[TEST 3] Ticker-based Flashing Test\n");
-    
-    // Test 1: 2 Hz flashing (door open simulation)
-    pc_printf("  - Starting 2 Hz flashing for 10 seconds...\n");
-    tickCount = 0;
-    tickerActive = true;
-    ledTicker.attach(&ledToggleISR, 250ms);  // Toggle every 250ms = 2 Hz
-    
-    for (int i = 10; i > 0; i--) {
-        pc_printf("  - Time remaining: %d seconds (toggles: %d)\n", i, tickCount);
-        ThisThread::sleep_for(1s);
-    }
-    
-    ledTicker.detach();
-    led = 0;
-    tickerActive = false;
-    pc_printf("  - Ticker stopped. Total toggles: %d\n", tickCount);
-    ThisThread::sleep_for(2s);
-    
-    // Test 2: 5 Hz flashing (fast alert)
-    pc_printf("  - Starting 5 Hz flashing for 5 seconds...\n");
-    tickCount = 0;
-    ledTicker.attach(&ledToggleISR, 100ms);  // Toggle every 100ms = 5 Hz
+void test_brightness() {
+    pc_printf("\n[TEST 3] Brightness Test\n");
     
-    for (int i = 5; i > 0; i--) {
-        pc_printf("  - Time remaining: %d seconds (toggles: %d)\n", i, tickCount);
-        ThisThread::sleep_for(1s);
+    static const uint8_t levels[] = {255, 128, 64, 26, 0};
+    led.play(LED_SOLID);
+    for (uint8_t level : levels) {
+        pc_printf("  - Solid at %d/255\n", level);
+        led.setBrightness(level);
+        ThisThread::sleep_for(2s);
     }
+    led.setBrightness(255);
+    led.play(LED_OFF);
     
-    ledTicker.detach();
-    led = 0;
-    pc_printf("  - Ticker stopped. Total toggles: %d\n", tickCount);
     pc_printf("  - Test complete.\n");
     ThisThread::sleep_for(2s);
 }
 
 /**
- * @brief Test 4: Heartbeat Pattern
+ * @brief Test 4: What the door shows in each state
  */
-void test_heartbeat() {
-    pc_printf("\n[TEST 4] Heartbeat Pattern Test\n");
-    pc_printf("  - Simulating heartbeat pattern (5 cycles)...\n");
+void test_door_status() {
+    pc_printf("\n[TEST 4] Door Status Patterns\n");
     
-    for (int i = 0; i < 5; i++) {
-        // First beat
-        led = 1;
-        ThisThread::sleep_for(100ms);
-        led = 0;
-        ThisThread::sleep_for(100ms);
-        
-        // Second beat
-        led = 1;
-        ThisThread::sleep_for(100ms);
-        led = 0;
-        ThisThread::sleep_for(600ms);
-        
-        pc_printf("  - Heartbeat %d/5\n", i + 1);
+    static const char* const names[] = {"CLOSED", "OPEN", "LOCKOUT", "FAULT"};
+    for (int status = StatusIndicator::STATUS_CLOSED; status <= StatusIndicator::STATUS_FAULT; status++) {
+        pc_printf("  - [%s] (5s)\n", names[status]);
+        led.showStatus(static_cast<StatusIndicator::Status>(status));
+        ThisThread::sleep_for(5s);
     }
+    led.play(LED_OFF);
     
     pc_printf("  - Test complete.\n");
     ThisThread::sleep_for(2s);
 }
 
 /**
- * @brief Test 5: Door Lock Simulation
- */
-void test_door_lock_simulation() {
-    pc_printf("\n[TEST 5] Door Lock Simulation\n");
-    
-    // State 1: Door Closed (LED solid ON)
-    pc_printf("  - [State 1] Door CLOSED - LED solid ON (3s)\n");
-    led = 1;
-    ThisThread::sleep_for(3s);
-    
-    // State 2: Password entered, door opening
-    pc_printf("  - [State 2] Password accepted, door OPENING...\n");
-    for (int i = 0; i < 3; i++) {
-        led = 0;
-        ThisThread::sleep_for(200ms);
-        led = 1;
-        ThisThread::sleep_for(200ms);
-    }
-    
-    // State 3: Door OPEN (LED flashing at 2 Hz for 10 seconds)
-    pc_printf("  - [State 3] Door OPEN - LED flashing 2 Hz (10s)\n");
-    tickCount = 0;
-    ledTicker.attach(&ledToggleISR, 250ms);
-    
-    for (int i = 10; i > 0; i--) {
-        pc_printf("  -   Closing in %d seconds...\n", i);
-        ThisThread::sleep_for(1s);
-    }
-    
-    ledTicker.detach();
-    
-    // State 4: Door closing
-    pc_printf("  - [State 4] Door CLOSING...\n");
-    for (int i = 0; i < 3; i++) {
-        led = 1;
-        ThisThread::sleep_for(200ms);
-        led = 0;
-        ThisThread::sleep_for(200ms);
-    }
-    
-    // State 5: Door CLOSED (LED solid ON)
-    pc_printf("  - [State 5] Door CLOSED - LED solid ON (3s)\n");
-    led = 1;
-    ThisThread::sleep_for(3s);
-    
-    led = 0;
-    pc_printf("  - Simulation complete.\n");
-    ThisThread::sleep_for(2s);
-}
-
-/**
- * @brief Test 6: Timing Accuracy Test
+ * @brief Test 5: The open-door blink needs no CPU at full brightness
  */
-void test_timing_accuracy() {
-    pc_printf("\n[TEST 6] Timing Accuracy Test\n");
-    pc_printf("  - Testing LED toggle timing precision...\n");
-    
-    Timer timer;
-    int intervals[] = {100, 250, 500, 1000};
-    
-    for (int i = 0; i < 4; i++) {
-        int interval = intervals[i];
-        pc_printf("  - Testing %dms interval (10 toggles)...\n", interval);
-        
-        timer.reset();
-        timer.start();
-        
-        for (int j = 0; j < 10; j++) {
-            led = !led;
-            ThisThread::sleep_for(std::chrono::milliseconds(interval));
-        }
-        
-        timer.stop();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(timer.elapsed_time()).count();
-        int expected = interval * 10;
-        int error = elapsed - expected;
-        
-        pc_printf("    Expected: %dms, Actual: %dms, Error: %dms\n", 
-                  expected, elapsed, error);
-        
-        led = 0;
-        ThisThread::sleep_for(1s);
-    }
-    
+void test_interrupt_load() {
+    pc_printf("\n[TEST 5] Interrupt Load Test\n");
+    
+    led.setBrightness(255);
+    uint32_t before = led.stepInterrupts();
+    led.showStatus(StatusIndicator::STATUS_OPEN);
+    ThisThread::sleep_for(5s);
+    uint32_t full = led.stepInterrupts() - before;
+    
+    led.setBrightness(64);
+    before = led.stepInterrupts();
+    ThisThread::sleep_for(5s);
+    uint32_t dimmed = led.stepInterrupts() - before;
+    
+    int expected = 5000 / (LED_FLASH_PERIOD_MS / 2);
+    pc_printf("  - Full brightness: %lu interrupts in 5s (%s)\n", (unsigned long)full,
+              full == 0 ? "PASS" : STATUS_LED_PWM ? "FAIL" : "GPIO build");
+    pc_printf("  - Dimmed: %lu interrupts in 5s (expected ~%d)\n", (unsigned long)dimmed, expected);
+    
+    led.setBrightness(255);
+    led.play(LED_OFF);
     pc_printf("  - Test complete.\n");
 }
 
 /**
  * @brief Main test function
  */
-int main() {
-    // Initialize LED (OFF)
-    led = 0;
-    
+TEST_MAIN() {
     // Wait for serial connection
     ThisThread::sleep_for(2s);
     
@@ -343,11 +181,10 @@ int main() {
         
         // Run all tests
         test_basic_onoff();
-        test_blinking_patterns();
-        test_ticker_flashing();
-        test_heartbeat();
-        test_door_lock_simulation();
-        test_timing_accuracy();
+        test_patterns();
+        test_brightness();
+        test_door_status();
+        test_interrupt_load();
         
         pc_printf("\n========================================\n");
         pc_printf("Test Cycle %d Complete!\n", testCycle);
@@ -360,4 +197,6 @@ int main() {
     }
 }
 
+TEST_SUITE_END()
+
 #endif // BUILD_TEST_LED
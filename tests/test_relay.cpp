@@ -1,7 +1,8 @@
 /**
  * @file test_relay.cpp
  * @brief Test program for Relay Module
- * @description Tests relay switching functionality
+ * @description Tests relay switching through LockDriver, including the
+ *              pull-in pulse, the PWM hold and the actuation timing
  * 
  * How to use:
  * 1. Comment out main.cpp in your build
@@ -11,35 +12,18 @@
  * 5. Verify lock opens/closes
  */
 
-#ifdef BUILD_TEST_RELAY
+#if defined(BUILD_TEST_RELAY) || defined(BUILD_TEST_ALL)
 #include "mbed.h"
+#include "LockDriver.h"
 
-#include <cstdarg>
-#include <cstdio>
+#include "test_common.h"
 
 using namespace std::chrono_literals;
 
-// Serial output for debugging
-BufferedSerial pc(USBTX, USBRX, 9600);
-void pc_printf(const char *format, ...)
-{
-    char buffer[256];
-    va_list args;
-    va_start(args, format);
-    int len = vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
-    if (len <= 0) {
-        return;
-    }
-    if (len > static_cast<int>(sizeof(buffer))) {
-        len = sizeof(buffer);
-    }
-    pc.write(buffer, len);
-}
+TEST_SUITE_BEGIN(test_relay)
 
-
-// Relay control pin
-DigitalOut relay(PA_8);
+// Relay control pin (TIM1_CH1): pull-in pulse, then the hold PWM
+LockDriver relay(PA_8, LockDriver::MODE_RELAY);
 
 // LED for visual feedback
 DigitalOut led(PC_13);
@@ -67,6 +51,7 @@ void printHeader() {
     pc_printf("  2. Rapid Switching Test\n");
     pc_printf("  3. Timed Lock Simulation\n");
     pc_printf("  4. Continuous Operation Test\n");
+    pc_printf("  6. Pull-in and Hold Timing\n");
     pc_printf("\n");
     pc_printf("Listen for relay clicking sound!\n");
     pc_printf("========================================\n");
@@ -84,7 +69,7 @@ void test_basic_onoff() {
         pc_printf("  - Cycle %d/5: ", i + 1);
         
         // Turn relay ON
-        relay = 1;
+        relay.setOpen(true);
         led = 1;
         onCount++;
         totalSwitches++;
@@ -92,7 +77,7 @@ void test_basic_onoff() {
         ThisThread::sleep_for(2s);
         
         // Turn relay OFF
-        relay = 0;
+        relay.setOpen(false);
         led = 0;
         offCount++;
         totalSwitches++;
@@ -111,13 +96,13 @@ void test_rapid_switching() {
     pc_printf("  - Testing rapid ON/OFF cycles...\n");
     
     for (int i = 0; i < 10; i++) {
-        relay = 1;
+        relay.setOpen(true);
         led = 1;
         onCount++;
         totalSwitches++;
         ThisThread::sleep_for(500ms);
         
-        relay = 0;
+        relay.setOpen(false);
         led = 0;
         offCount++;
         totalSwitches++;
@@ -138,7 +123,7 @@ void test_timed_lock_simulation() {
     
     // Open lock
     pc_printf("  - [0s] Lock OPENING...\n");
-    relay = 1;
+    relay.setOpen(true);
     led = 1;
     onCount++;
     totalSwitches++;
@@ -151,7 +136,7 @@ void test_timed_lock_simulation() {
     
     // Close lock
     pc_printf("  - [10s] Lock CLOSING...\n");
-    relay = 0;
+    relay.setOpen(false);
     led = 0;
     offCount++;
     totalSwitches++;
@@ -173,13 +158,13 @@ void test_pulse_width() {
     for (int i = 0; i < numDurations; i++) {
         pc_printf("  - Pulse %d/%d: %dms ON...", i + 1, numDurations, durations[i]);
         
-        relay = 1;
+        relay.setOpen(true);
         led = 1;
         onCount++;
         totalSwitches++;
         ThisThread::sleep_for(std::chrono::milliseconds(durations[i]));
         
-        relay = 0;
+        relay.setOpen(false);
         led = 0;
         offCount++;
         totalSwitches++;
@@ -199,13 +184,13 @@ void test_stress() {
     pc_printf("  - Testing relay endurance...\n");
     
     for (int i = 0; i < 100; i++) {
-        relay = 1;
+        relay.setOpen(true);
         led = 1;
         onCount++;
         totalSwitches++;
         ThisThread::sleep_for(100ms);
         
-        relay = 0;
+        relay.setOpen(false);
         led = 0;
         offCount++;
         totalSwitches++;
@@ -219,6 +204,43 @@ void test_stress() {
     pc_printf("  - Stress test complete. 200 switches executed.\n");
 }
 
+/**
+ * @brief Test 6: Pull-in pulse, hold duty and actuation timing
+ */
+void test_pull_in_hold() {
+    pc_printf("\n[TEST 6] Pull-in and Hold Timing\n");
+    pc_printf("  - Pull-in %dms at 100%%, then hold at %d%%\n", RELAY_PULL_IN_MS, RELAY_HOLD_PERCENT);
+    
+    uint32_t minUs = 0xFFFFFFFF;
+    uint32_t maxUs = 0;
+    for (int i = 0; i < 5; i++) {
+        uint32_t before = relay.actuations();
+        relay.setOpen(true);
+        led = 1;
+        onCount++;
+        totalSwitches++;
+        ThisThread::sleep_for(std::chrono::milliseconds(RELAY_PULL_IN_MS + 50));
+        
+        bool done = relay.actuations() == before + 1 && !relay.actuating();
+        uint32_t us = relay.lastActuationUs();
+        minUs = us < minUs ? us : minUs;
+        maxUs = us > maxUs ? us : maxUs;
+        pc_printf("  - Open %d/5: pulled in after %lu us (%s), holding 2s\n", i + 1, (unsigned long)us,
+                  done ? "reported" : "NOT REPORTED");
+        ThisThread::sleep_for(2s);  // The relay must stay in on the hold duty
+        
+        relay.setOpen(false);
+        led = 0;
+        offCount++;
+        totalSwitches++;
+        ThisThread::sleep_for(1s);
+    }
+    
+    pc_printf("  - Actuation time %lu..%lu us (jitter %lu us)\n", (unsigned long)minUs, (unsigned long)maxUs,
+              (unsigned long)(maxUs - minUs));
+    pc_printf("  - Test complete. The relay must not drop out while held.\n");
+}
+
 /**
  * @brief Prints test statistics
  */
@@ -249,19 +271,19 @@ void manual_control_mode() {
             char cmd = 0; pc.read(&cmd, 1);
             
             if (cmd == '1') {
-                relay = 1;
+                relay.setOpen(true);
                 led = 1;
                 onCount++;
                 totalSwitches++;
                 pc_printf("  - Relay ON\n");
             } else if (cmd == '0') {
-                relay = 0;
+                relay.setOpen(false);
                 led = 0;
                 offCount++;
                 totalSwitches++;
                 pc_printf("  - Relay OFF\n");
             } else if (cmd == 'q' || cmd == 'Q') {
-                relay = 0;
+                relay.setOpen(false);
                 led = 0;
                 pc_printf("  - Exiting manual mode...\n");
                 break;
@@ -277,9 +299,9 @@ void manual_control_mode() {
 /**
  * @brief Main test function
  */
-int main() {
+TEST_MAIN() {
     // Initialize relay and LED (both OFF)
-    relay = 0;
+    relay.setOpen(false);
     led = 0;
     
     // Wait for serial connection
@@ -311,6 +333,9 @@ int main() {
         test_stress();
         ThisThread::sleep_for(2s);
         
+        test_pull_in_hold();
+        ThisThread::sleep_for(2s);
+        
         // Print statistics
         printStatistics();
         
@@ -350,4 +375,6 @@ int main() {
     }
 }
 
+TEST_SUITE_END()
+
 #endif // BUILD_TEST_RELAY
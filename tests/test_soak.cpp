@@ -0,0 +1,443 @@
+/**
+ * @file test_soak.cpp
+ * @brief Unattended timing soak: auto-close, lockout and relay switching
+ * @description Runs the real DoorController, event queue and LockDriver
+ *              through thousands of open/close and lockout cycles with a
+ *              scripted keypad, measures every cycle against the configured
+ *              times and prints histograms and a pass/fail verdict
+ *
+ * How to use:
+ * 1. Comment out main.cpp in your build
+ * 2. Compile this test file instead (BUILD_TEST_SOAK)
+ * 3. Connect serial monitor at 9600 baud and leave the board running
+ * 4. Optional: wire the relay contact to SOAK_FEEDBACK_PIN (NO contact to 3V3,
+ *    the input is pulled down) to time the contact itself
+ *
+ * Per cycle, on the LowPowerTimer (it keeps counting in STOP mode, where the
+ * door normally waits):
+ *   open_error     lock command to close command, minus openTimeMs
+ *   lockout_error  lockout start to lockout end, minus lockoutTimeMs
+ *   key_to_command '#' to the lock command (software path)
+ *   contact_*      lock command to the relay contact changing (feedback pin only)
+ *
+ * Output format:
+ *   # comment / context lines
+ *   HIST,<name>,<bin start us>,<count>   SOAK_BINS bins between the limits, plus under/over
+ *   SOAK,<name>,us,<samples>,<min>,<avg>,<max>,<low limit>,<high limit>,PASS|FAIL
+ *   SOAK,result,...,PASS|FAIL            every measurement within its limits
+ * With TELEMETRY each summary is also streamed as a TLM_BENCH frame.
+ *
+ * Lengths shorter than the defaults (for a quicker run) can be set with
+ * -DSOAK_OPEN_MS=... and -DSOAK_LOCKOUT_MS=... (DoorSettings limits apply).
+ */
+
+#ifdef BUILD_TEST_SOAK
+#include "mbed.h"
+#include "DoorController.h"
+#include "DeadlineScheduler.h"
+#include "LCDFrame.h"
+#include "LockDriver.h"
+#include "QueueScheduler.h"
+#include "SpscRing.h"
+#include "config.h"
+
+#include "test_common.h"
+
+using namespace std::chrono_literals;
+
+// ==================== SOAK SETTINGS ====================
+#ifndef SOAK_CYCLES
+#define SOAK_CYCLES 2000                    // Door cycles, lockout cycles included
+#endif
+#ifndef SOAK_LOCKOUT_EVERY
+#define SOAK_LOCKOUT_EVERY 10               // Every Nth cycle is a lockout instead of an open
+#endif
+#ifndef SOAK_OPEN_MS
+#define SOAK_OPEN_MS OPEN_TIME_MS
+#endif
+#ifndef SOAK_LOCKOUT_MS
+#define SOAK_LOCKOUT_MS LOCKOUT_TIME_MS
+#endif
+#ifndef SOAK_FEEDBACK_PIN
+#define SOAK_FEEDBACK_PIN NC                // Input wired to the relay contact, NC = none
+#endif
+#define SOAK_EARLY_LIMIT_US 1000            // Kernel ticks are 1ms - a period may end that much early
+#define SOAK_LATE_LIMIT_US (DEADLINE_TIMER_MS * 1000)    // Same allowance as the deadline tracker
+#define SOAK_KEY_LIMIT_US (DEADLINE_KEY_MS * 1000)
+#define SOAK_CONTACT_LIMIT_US 20000         // Relay operate/release time (datasheet figure of common modules)
+#define SOAK_BINS 20
+#define SOAK_REPORT_EVERY 100               // Progress line every N cycles
+
+// ==================== FIXTURE ====================
+LowPowerTimer soakClock;                    // Every timestamp of the soak
+
+inline uint32_t soakNowUs() {
+    return (uint32_t)soakClock.elapsed_time().count();
+}
+
+static const uint32_t FLAG_OPENED = 1 << 0;
+static const uint32_t FLAG_CLOSED = 1 << 1;
+static const uint32_t FLAG_LOCKOUT = 1 << 2;
+static const uint32_t FLAG_LOCKOUT_END = 1 << 3;
+static const uint32_t FLAG_CONTACT_ON = 1 << 4;
+static const uint32_t FLAG_CONTACT_OFF = 1 << 5;
+EventFlags soakFlags;
+
+/**
+ * @brief Keypad replaced by key events the soak pushes
+ */
+class ScriptedKeys : public KeySource {
+public:
+    bool pollEvent(KeyEvent& event) override {
+        return _events.pop(event);
+    }
+
+    /**
+     * @brief Queue a press and release of one key
+     * @return Timestamp of the press
+     */
+    uint32_t tap(char key) {
+        uint32_t now = soakNowUs();
+        _events.push({key, KeyEvent::Press, 0, now});
+        _events.push({key, KeyEvent::Release, 0, now});
+        return now;
+    }
+
+private:
+    SpscRing<KeyEvent, 128> _events;        // Main thread -> door thread (a lockout of 20 attempts is 80)
+};
+
+/**
+ * @brief Frames go nowhere - the soak needs no LCD
+ */
+class NullDisplay : public DisplaySink {
+public:
+    void submit(const LCDFrame&) override {
+        frames++;
+    }
+    void setBacklight(bool) override {}
+
+    uint32_t frames = 0;
+};
+
+/**
+ * @brief LockDriver with the command times recorded
+ */
+class TimedLock : public LockActuator {
+public:
+    explicit TimedLock(LockDriver& driver) : _driver(driver) {}
+
+    void setOpen(bool open) override {
+        uint32_t now = soakNowUs();
+        _driver.setOpen(open);
+        if (open) {
+            openedUs = now;
+            soakFlags.set(FLAG_OPENED);
+        } else {
+            closedUs = now;
+            soakFlags.set(FLAG_CLOSED);
+        }
+    }
+
+    volatile uint32_t openedUs = 0;
+    volatile uint32_t closedUs = 0;
+
+private:
+    LockDriver& _driver;
+};
+
+/**
+ * @brief Audit sink that timestamps the lockout start and end
+ */
+class TimedAudit : public AuditSink {
+public:
+    void record(Event event, uint8_t, uint16_t) override {
+        if (event == EVENT_LOCKOUT) {
+            lockedUs = soakNowUs();
+            soakFlags.set(FLAG_LOCKOUT);
+        } else if (event == EVENT_LOCKOUT_END) {
+            unlockedUs = soakNowUs();
+            soakFlags.set(FLAG_LOCKOUT_END);
+        }
+    }
+
+    volatile uint32_t lockedUs = 0;
+    volatile uint32_t unlockedUs = 0;
+};
+
+LockDriver lockDriver(PA_8, USE_RELAY ? LockDriver::MODE_RELAY : LockDriver::MODE_SERVO);
+TimedLock lock(lockDriver);
+ScriptedKeys keys;
+NullDisplay display;
+TimedAudit audit;
+
+EventQueue queue(32 * EVENTS_EVENT_SIZE);
+QueueScheduler scheduler(queue);
+DeadlineScheduler deadlines(scheduler);
+DoorController door(keys, display, lock, deadlines, audit);
+DoorSettings settings;
+Thread doorThread;
+
+// Relay contact edges (ISR)
+volatile uint32_t contactOnUs = 0;
+volatile uint32_t contactOffUs = 0;
+
+void onContactOn() {
+    contactOnUs = soakNowUs();
+    soakFlags.set(FLAG_CONTACT_ON);
+}
+
+void onContactOff() {
+    contactOffUs = soakNowUs();
+    soakFlags.set(FLAG_CONTACT_OFF);
+}
+
+// ==================== HISTOGRAMS ====================
+/**
+ * @brief Distribution of one measurement with its limits
+ */
+struct Histogram {
+    const char* name;
+    int32_t lowLimit;
+    int32_t highLimit;
+    uint32_t bins[SOAK_BINS];
+    uint32_t under;                 // Below lowLimit
+    uint32_t over;                  // Above highLimit
+    uint32_t samples;
+    int32_t min;
+    int32_t max;
+    int64_t total;
+
+    Histogram(const char* name, int32_t lowLimit, int32_t highLimit)
+        : name(name), lowLimit(lowLimit), highLimit(highLimit), bins(), under(0), over(0),
+          samples(0), min(INT32_MAX), max(INT32_MIN), total(0) {}
+
+    int32_t binWidth() const {
+        return (highLimit - lowLimit + SOAK_BINS - 1) / SOAK_BINS;
+    }
+
+    /**
+     * @return false if the value is outside the limits
+     */
+    bool add(int32_t value) {
+        samples++;
+        total += value;
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+        if (value < lowLimit) {
+            under++;
+            return false;
+        }
+        if (value > highLimit) {
+            over++;
+            return false;
+        }
+        int bin = (value - lowLimit) / binWidth();
+        bins[bin < SOAK_BINS ? bin : SOAK_BINS - 1]++;
+        return true;
+    }
+
+    bool passed() const {
+        return under == 0 && over == 0;
+    }
+
+    void print() const {
+        if (samples == 0) {
+            pc_printf("SOAK,%s,us,0,,,,%ld,%ld,SKIP\n", name, (long)lowLimit, (long)highLimit);
+            return;
+        }
+        pc_printf("HIST,%s,under,%lu\n", name, (unsigned long)under);
+        for (int i = 0; i < SOAK_BINS; i++) {
+            if (bins[i]) {
+                pc_printf("HIST,%s,%ld,%lu\n", name, (long)(lowLimit + i * binWidth()), (unsigned long)bins[i]);
+            }
+        }
+        pc_printf("HIST,%s,over,%lu\n", name, (unsigned long)over);
+        int32_t avg = (int32_t)(total / (int64_t)samples);
+        pc_printf("SOAK,%s,us,%lu,%ld,%ld,%ld,%ld,%ld,%s\n", name, (unsigned long)samples, (long)min,
+                  (long)avg, (long)max, (long)lowLimit, (long)highLimit, passed() ? "PASS" : "FAIL");
+#if TELEMETRY
+        // Signed values as their two's complement
+        tlmBench(name, samples, (uint32_t)min, (uint32_t)avg, (uint32_t)max);
+#endif
+    }
+};
+
+Histogram openError("open_error", -SOAK_EARLY_LIMIT_US, SOAK_LATE_LIMIT_US);
+Histogram lockoutError("lockout_error", -SOAK_EARLY_LIMIT_US, SOAK_LATE_LIMIT_US);
+Histogram keyToCommand("key_to_command", 0, SOAK_KEY_LIMIT_US);
+Histogram contactOn("contact_on", 0, SOAK_CONTACT_LIMIT_US);
+Histogram contactOff("contact_off", 0, SOAK_CONTACT_LIMIT_US);
+uint32_t failedCycles = 0;          // A step that never happened (timeout)
+
+// ==================== CYCLES ====================
+/**
+ * @brief Hand the queued keys to the door thread, like the keypad interrupt does
+ */
+void deliverKeys() {
+    queue.call(callback(&door, &DoorController::processKeys));
+}
+
+/**
+ * @brief Wait for one flag
+ * @return false after timeoutMs
+ */
+bool waitFor(uint32_t flag, uint32_t timeoutMs) {
+    uint32_t flags = soakFlags.wait_any_for(flag, std::chrono::milliseconds(timeoutMs));
+    return !(flags & osFlagsError) && (flags & flag);
+}
+
+/**
+ * @brief Relay contact change after a command, when the feedback pin is wired
+ */
+void measureContact(Histogram& histogram, uint32_t flag, volatile uint32_t& edgeUs, uint32_t commandUs,
+                    int cycle) {
+    if (SOAK_FEEDBACK_PIN == NC) {
+        return;
+    }
+    if (!waitFor(flag, SOAK_CONTACT_LIMIT_US / 1000 * 5)) {
+        pc_printf("# cycle %d: no %s edge\n", cycle, histogram.name);
+        histogram.add(INT32_MAX);
+        return;
+    }
+    if (!histogram.add((int32_t)(edgeUs - commandUs))) {
+        pc_printf("# cycle %d: %s %ldus\n", cycle, histogram.name, (long)(int32_t)(edgeUs - commandUs));
+    }
+}
+
+/**
+ * @brief PIN, '#', then the auto-close
+ */
+void openCycle(int cycle) {
+    soakFlags.clear();
+    for (const char* c = PASSWORD; *c; c++) {
+        keys.tap(*c);
+    }
+    uint32_t hashUs = keys.tap('#');
+    deliverKeys();
+
+    if (!waitFor(FLAG_OPENED, 1000)) {
+        pc_printf("# cycle %d: lock never opened\n", cycle);
+        failedCycles++;
+        return;
+    }
+    if (!keyToCommand.add((int32_t)(lock.openedUs - hashUs))) {
+        pc_printf("# cycle %d: key_to_command %ldus\n", cycle, (long)(int32_t)(lock.openedUs - hashUs));
+    }
+    measureContact(contactOn, FLAG_CONTACT_ON, contactOnUs, lock.openedUs, cycle);
+
+    if (!waitFor(FLAG_CLOSED, settings.openTimeMs + 1000)) {
+        pc_printf("# cycle %d: lock never closed\n", cycle);
+        failedCycles++;
+        return;
+    }
+    int32_t error = (int32_t)(lock.closedUs - lock.openedUs) - (int32_t)(settings.openTimeMs * 1000);
+    if (!openError.add(error)) {
+        pc_printf("# cycle %d: open_error %ldus\n", cycle, (long)error);
+    }
+    measureContact(contactOff, FLAG_CONTACT_OFF, contactOffUs, lock.closedUs, cycle);
+}
+
+/**
+ * @brief Wrong PINs until the lockout, then wait for its end
+ */
+void lockoutCycle(int cycle) {
+    soakFlags.clear();
+    for (int i = 0; i < settings.maxFailedAttempts; i++) {
+        keys.tap(PASSWORD[0] == '0' ? '1' : '0');  // One digit never matches PASSWORD
+        keys.tap('#');
+    }
+    deliverKeys();
+
+    if (!waitFor(FLAG_LOCKOUT, 1000)) {
+        pc_printf("# cycle %d: no lockout after %d wrong PINs\n", cycle, settings.maxFailedAttempts);
+        failedCycles++;
+        return;
+    }
+    if (!waitFor(FLAG_LOCKOUT_END, settings.lockoutTimeMs + 1000)) {
+        pc_printf("# cycle %d: lockout never ended\n", cycle);
+        failedCycles++;
+        return;
+    }
+    int32_t error = (int32_t)(audit.unlockedUs - audit.lockedUs) - (int32_t)(settings.lockoutTimeMs * 1000);
+    if (!lockoutError.add(error)) {
+        pc_printf("# cycle %d: lockout_error %ldus\n", cycle, (long)error);
+    }
+}
+
+/**
+ * @brief Door timer lateness as the deadline tracker saw it
+ */
+void printDeadlines() {
+    const DeadlineScheduler::TaskStats& timers = deadlines.task(DeadlineScheduler::TASK_TIMERS);
+    pc_printf("# timers: runs=%lu overruns=%lu worst_late_ms=%lu untracked=%lu\n", (unsigned long)timers.runs,
+              (unsigned long)timers.overruns, (unsigned long)timers.worstLateMs, (unsigned long)deadlines.untracked());
+}
+
+int main() {
+    pc_printf("\n# ========================================\n");
+    pc_printf("# Door Lock Timing Soak\n");
+    pc_printf("# build=%s %s core_clock=%lu\n", __DATE__, __TIME__, (unsigned long)SystemCoreClock);
+    pc_printf("# ========================================\n");
+
+    soakClock.start();
+    lockDriver.setOpen(false);
+
+    settings = DoorSettings::defaults();
+    settings.openTimeMs = SOAK_OPEN_MS;
+    settings.lockoutTimeMs = SOAK_LOCKOUT_MS;
+    if (!settings.valid()) {
+        pc_printf("# SOAK_OPEN_MS / SOAK_LOCKOUT_MS outside the DoorSettings limits\n");
+        return 1;
+    }
+    pc_printf("# cycles=%d lockout_every=%d open_ms=%lu lockout_ms=%lu lock=%s feedback=%s\n", SOAK_CYCLES,
+              SOAK_LOCKOUT_EVERY, (unsigned long)settings.openTimeMs, (unsigned long)settings.lockoutTimeMs,
+              USE_RELAY ? "relay" : "servo", SOAK_FEEDBACK_PIN == NC ? "none" : "wired");
+
+    InterruptIn* contact = nullptr;
+    if (SOAK_FEEDBACK_PIN != NC) {
+        contact = new InterruptIn(SOAK_FEEDBACK_PIN, PullDown);
+        contact->rise(onContactOn);
+        contact->fall(onContactOff);
+    }
+
+    // The door runs on its own queue thread, as in the application; this thread scripts it
+    door.setSettings(&settings);
+    door.begin(nullptr);  // Compiled-in PASSWORD, the PIN store stays untouched
+    doorThread.start(callback(&queue, &EventQueue::dispatch_forever));
+
+    int lockouts = 0;
+    for (int cycle = 1; cycle <= SOAK_CYCLES; cycle++) {
+        if (SOAK_LOCKOUT_EVERY > 0 && cycle % SOAK_LOCKOUT_EVERY == 0) {
+            lockoutCycle(cycle);
+            lockouts++;
+        } else {
+            openCycle(cycle);
+        }
+        if (cycle % SOAK_REPORT_EVERY == 0) {
+            pc_printf("# cycle %d/%d: open worst %ldus, lockout worst %ldus, failed %lu\n", cycle, SOAK_CYCLES,
+                      (long)(openError.samples ? openError.max : 0), (long)(lockoutError.samples ? lockoutError.max : 0),
+                      (unsigned long)failedCycles);
+        }
+    }
+
+    pc_printf("# SOAK,name,unit,samples,min,avg,max,low_limit,high_limit,verdict\n");
+    openError.print();
+    lockoutError.print();
+    keyToCommand.print();
+    contactOn.print();
+    contactOff.print();
+    printDeadlines();
+    pc_printf("# lock actuations=%lu frames=%lu lockouts=%d\n", (unsigned long)lockDriver.actuations(),
+              (unsigned long)display.frames, lockouts);
+
+    bool passed = failedCycles == 0 && openError.passed() && lockoutError.passed() && keyToCommand.passed() &&
+                  contactOn.passed() && contactOff.passed();
+    pc_printf("SOAK,result,cycles,%d,,,,,,%s\n", SOAK_CYCLES, passed ? "PASS" : "FAIL");
+    pc_printf("# done\n");
+    while (true) {
+        ThisThread::sleep_for(1s);
+    }
+}
+
+#endif // BUILD_TEST_SOAK
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Decode the door lock's binary telemetry stream into text.
+
+Frames (see Telemetry.h), little-endian:
+
+    0xA5 | length | id | seq | timestamp (u32 us) | payload | CRC-16 (u16)
+
+Event names and payload layouts are read from TelemetryEvents.h, so the
+decoder follows the firmware without edits.
+
+Usage:
+    tools/telemetry_decode.py /dev/ttyUSB0            # live, 921600 baud
+    tools/telemetry_decode.py /dev/ttyUSB0 -b 460800
+    tools/telemetry_decode.py capture.bin             # recorded stream
+    tools/telemetry_decode.py - < capture.bin         # stdin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_SIZE = 8
+CRC_SIZE = 2
+DEFAULT_EVENTS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "TelemetryEvents.h")
+
+AUDIT_EVENTS = {
+    1: "boot", 2: "granted", 3: "denied", 4: "lockout", 5: "lockout_end",
+    6: "key", 7: "pin_set", 8: "pin_del", 9: "watchdog_reset", 10: "config",
+    11: "console_denied", 12: "clock_set",
+}
+
+
+def load_events(path):
+    """Map event ID -> (name, [(field, struct code)]) from TelemetryEvents.h"""
+    pattern = re.compile(r"^\s*TLM_(\w+)\s*=\s*(\d+)\s*,?\s*//\s*(.*)$")
+    events = {}
+    with open(path) as header:
+        for line in header:
+            match = pattern.match(line)
+            if not match:
+                continue
+            fields = [tuple(field.split(":", 1)) for field in match.group(3).split()]
+            events[int(match.group(2))] = (match.group(1), fields)
+    return events
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT (polynomial 0x1021), as computed by the firmware"""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def decode_payload(fields, payload):
+    values = []
+    offset = 0
+    for name, code in fields:
+        if code == "s":
+            values.append((name, payload[offset:].decode("ascii", "replace")))
+            offset = len(payload)
+            continue
+        size = struct.calcsize("<" + code)
+        if offset + size > len(payload):
+            values.append((name, "?"))
+            continue
+        value = struct.unpack_from("<" + code, payload, offset)[0]
+        if code == "c":
+            value = value.decode("ascii", "replace")
+        values.append((name, value))
+        offset += size
+    return values
+
+
+def format_frame(events, event_id, seq, timestamp, payload):
+    name, fields = events.get(event_id, ("EVENT_%d" % event_id, []))
+    values = decode_payload(fields, payload)
+    if name == "AUDIT" and values:
+        values[0] = ("event", AUDIT_EVENTS.get(values[0][1], values[0][1]))
+    if name == "TEXT":
+        text = values[0][1] if values else ""
+        return "%12.6f %3d TEXT %s" % (timestamp / 1e6, seq, text)
+    if not fields and payload:
+        values = [("raw", payload.hex())]
+    return "%12.6f %3d %s %s" % (timestamp / 1e6, seq, name,
+                                 " ".join("%s=%s" % item for item in values))
+
+
+class Decoder:
+    """Finds frames in a byte stream; resynchronises on the next sync byte after an error"""
+
+    def __init__(self, events, max_payload, out):
+        self.events = events
+        self.max_payload = max_payload
+        self.out = out
+        self.buffer = bytearray()
+        self.expected_seq = None
+        self.frames = 0
+        self.crc_errors = 0
+        self.lost = 0
+
+    def feed(self, data):
+        self.buffer += data
+        while True:
+            start = self.buffer.find(bytes([SYNC]))
+            if start < 0:
+                self.buffer.clear()
+                return
+            del self.buffer[:start]
+            if len(self.buffer) < 2:
+                return
+            length = self.buffer[1]
+            if length > self.max_payload:
+                del self.buffer[:1]  # Not a frame start
+                continue
+            size = HEADER_SIZE + length + CRC_SIZE
+            if len(self.buffer) < size:
+                return
+            frame = bytes(self.buffer[:size])
+            (crc,) = struct.unpack_from("<H", frame, size - CRC_SIZE)
+            if crc16(frame[1:size - CRC_SIZE]) != crc:
+                self.crc_errors += 1
+                del self.buffer[:1]
+                continue
+            del self.buffer[:size]
+            self.frame(frame, length)
+
+    def frame(self, frame, length):
+        event_id, seq, timestamp = struct.unpack_from("<BBI", frame, 2)
+        if self.expected_seq is not None and seq != self.expected_seq:
+            missing = (seq - self.expected_seq) & 0xFF
+            self.lost += missing
+            self.out.write("# %d frame(s) lost\n" % missing)
+        self.expected_seq = (seq + 1) & 0xFF
+        self.frames += 1
+        payload = frame[HEADER_SIZE:HEADER_SIZE + length]
+        self.out.write(format_frame(self.events, event_id, seq, timestamp, payload) + "\n")
+        self.out.flush()
+
+
+def open_source(source, baud):
+    if source == "-":
+        return sys.stdin.buffer, False
+    if os.path.isfile(source):
+        return open(source, "rb"), False
+    import serial  # pyserial, in requirements.txt
+    return serial.Serial(source, baud, timeout=0.1), True
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode door lock telemetry frames")
+    parser.add_argument("source", help="serial port, capture file, or - for stdin")
+    parser.add_argument("-b", "--baud", type=int, default=921600, help="serial baud rate (TELEMETRY_BAUD)")
+    parser.add_argument("-e", "--events", default=DEFAULT_EVENTS, help="path to TelemetryEvents.h")
+    parser.add_argument("-m", "--max-payload", type=int, default=32, help="TELEMETRY_MAX_PAYLOAD")
+    args = parser.parse_args()
+
+    decoder = Decoder(load_events(args.events), args.max_payload, sys.stdout)
+    stream, live = open_source(args.source, args.baud)
+    try:
+        while True:
+            data = stream.read(256)
+            if data:
+                decoder.feed(data)
+            elif not live:
+                break
+    except KeyboardInterrupt:
+        pass
+    sys.stderr.write("%d frames, %d lost, %d CRC errors\n" % (decoder.frames, decoder.lost, decoder.crc_errors))
+
+
+if __name__ == "__main__":
+    main()